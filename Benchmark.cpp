@@ -0,0 +1,939 @@
+/**
+ * Micro benchmarks for the Fraction library.
+ * Build and run with: make bench && ./bench
+ */
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+#include "sources/Fraction.hpp"
+#include "sources/FractionColumn.hpp"
+#include "sources/FractionExpression.hpp"
+#include "sources/FractionSimd.hpp"
+#include "sources/Gcd.hpp"
+#include "sources/LazyFraction.hpp"
+#include "sources/Overflow.hpp"
+
+using namespace ariel;
+
+namespace
+{
+    const int ROUNDS = 20;
+    const size_t SAMPLES = 100000;
+
+    // Prevents the optimizer from dropping the measured work.
+    volatile long long sink = 0;
+
+    // Runs body() ROUNDS times and prints the average time per operation and the throughput.
+    template <typename Body>
+    void measure(const string &name, size_t operations, Body body)
+    {
+        long long checksum = 0;
+        auto start = chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round)
+        {
+                checksum += body();
+        }
+        auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        sink = sink + checksum;
+        const double per_operation = elapsed / (double(ROUNDS) * double(operations));
+        cout << "  " << left << setw(44) << name << fixed << setprecision(2)
+             << per_operation << " ns/op  " << setprecision(1) << 1000 / per_operation << " M/s" << endl;
+    }
+
+    // Operand pairs shaped like the values Fraction::reduce sees.
+    vector<pair<int, int>> operands(int max_numerator, int min_denominator, int max_denominator, unsigned seed)
+    {
+        mt19937 gen(seed);
+        uniform_int_distribution<int> num(-max_numerator, max_numerator);
+        uniform_int_distribution<int> den(min_denominator, max_denominator);
+        vector<pair<int, int>> result(SAMPLES);
+        for (auto &operand : result)
+        {
+                operand = {num(gen), den(gen)};
+        }
+        return result;
+    }
+
+    void bench_gcd()
+    {
+        cout << "gcd engine" << endl;
+        const pair<const char *, vector<pair<int, int>>> distributions[] = {
+            {"integers (d = 1)", operands(1000000, 1, 1, 5)},
+            {"small (|n| <= 100, d <= 100)", operands(100, 1, 100, 1)},
+            {"float scaled (d = 1000)", operands(1000000, 1000, 1000, 2)},
+            {"products (|n|, d <= 1e6)", operands(1000000, 1, 1000000, 3)},
+            {"full range", operands(numeric_limits<int>::max(), 1, numeric_limits<int>::max(), 4)},
+        };
+
+        for (const auto &[name, inputs] : distributions)
+        {
+                measure(string("std::gcd      ") + name, inputs.size(), [&]
+                        {
+                            long long sum = 0;
+                            for (const auto &[num, den] : inputs)
+                                sum += gcd(num, den);
+                            return sum; });
+                measure(string("fraction_gcd  ") + name, inputs.size(), [&]
+                        {
+                            long long sum = 0;
+                            for (const auto &[num, den] : inputs)
+                                sum += fraction_gcd(num, den);
+                            return sum; });
+        }
+    }
+
+    // Adds and multiplies pairs of small fractions with the given backing type.
+    template <typename FractionT>
+    void bench_backing_type(const string &name, const vector<pair<int, int>> &inputs)
+    {
+        vector<FractionT> fractions;
+        for (const auto &[num, den] : inputs)
+                fractions.emplace_back(num, den);
+
+        measure(name + " a + b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += (fractions[i - 1] + fractions[i]) == fractions[i];
+                    return sum; });
+        measure(name + " a * b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += (fractions[i - 1] * fractions[i]) == fractions[i];
+                    return sum; });
+    }
+
+    void bench_backing_types()
+    {
+        cout << "backing integer types (|n|, d <= 1000)" << endl;
+        const vector<pair<int, int>> inputs = operands(1000, 1, 1000, 6);
+        bench_backing_type<Fraction>("Fraction   ", inputs);
+        bench_backing_type<Fraction64>("Fraction64 ", inputs);
+        bench_backing_type<Fraction128>("Fraction128", inputs);
+        bench_backing_type<BigFraction>("BigFraction", inputs);
+    }
+
+    // The original overflow helper: a runtime switch on op with every operand widened to long long
+    int legacy_overflow_check(int num1, int num2, char op)
+    {
+        const int max_int = numeric_limits<int>::max();
+        const int min_int = numeric_limits<int>::min();
+
+        long long new_num1 = static_cast<long long>(num1);
+        long long new_num2 = static_cast<long long>(num2);
+
+        switch (op)
+        {
+        case '+':
+                if (new_num1 + new_num2 > max_int || (new_num1 + new_num2) < min_int)
+                    throw overflow_error("Overflow");
+                return (num1 + num2);
+        case '-':
+                if ((new_num1 - new_num2) > max_int || (new_num1 - new_num2) < min_int)
+                    throw overflow_error("Overflow");
+                return (num1 - num2);
+        case '*':
+                if (new_num1 * new_num2 > max_int || (new_num1 * new_num2) < min_int)
+                    throw overflow_error("Overflow");
+                return (num1 * num2);
+        default:
+                return 1;
+        }
+    }
+
+    // The original operator+ and operator*, built on legacy_overflow_check
+    Fraction legacy_add(const Fraction &num1, const Fraction &num2)
+    {
+        int lcm = abs(legacy_overflow_check(num1.getDenominator(), num2.getDenominator(), '*') / gcd(num1.getDenominator(), num2.getDenominator()));
+        int num_1 = legacy_overflow_check(num1.getNumerator(), (lcm / num1.getDenominator()), '*');
+        int num_2 = legacy_overflow_check(num2.getNumerator(), (lcm / num2.getDenominator()), '*');
+        return Fraction(legacy_overflow_check(num_1, num_2, '+'), lcm);
+    }
+
+    Fraction legacy_multiply(const Fraction &num1, const Fraction &num2)
+    {
+        return Fraction(legacy_overflow_check(num1.getNumerator(), num2.getNumerator(), '*'),
+                        legacy_overflow_check(num1.getDenominator(), num2.getDenominator(), '*'));
+    }
+
+    void bench_overflow_checks()
+    {
+        cout << "overflow checks (|n|, d <= 1000)" << endl;
+        const vector<pair<int, int>> inputs = operands(1000, 1, 1000, 8);
+        measure("legacy overflow_check(a, b, '+')", inputs.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const auto &[num, den] : inputs)
+                        sum += legacy_overflow_check(num, den, '+');
+                    return sum; });
+        measure("overflow_check_add(a, b)", inputs.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const auto &[num, den] : inputs)
+                        sum += overflow_check_add(num, den);
+                    return sum; });
+        measure("legacy overflow_check(a, b, '*')", inputs.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const auto &[num, den] : inputs)
+                        sum += legacy_overflow_check(num, den, '*');
+                    return sum; });
+        measure("overflow_check_multiply(a, b)", inputs.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const auto &[num, den] : inputs)
+                        sum += overflow_check_multiply(num, den);
+                    return sum; });
+
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : inputs)
+                fractions.emplace_back(num, den);
+        measure("legacy a + b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += legacy_add(fractions[i - 1], fractions[i]).getDenominator();
+                    return sum; });
+        measure("a + b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += (fractions[i - 1] + fractions[i]).getDenominator();
+                    return sum; });
+        measure("legacy a * b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += legacy_multiply(fractions[i - 1], fractions[i]).getDenominator();
+                    return sum; });
+        measure("a * b", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += (fractions[i - 1] * fractions[i]).getDenominator();
+                    return sum; });
+    }
+
+    void bench_error_handling()
+    {
+        cout << "overflow handling (every 10th product overflows)" << endl;
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 9))
+                fractions.emplace_back(num, den);
+        for (size_t i = 0; i < fractions.size(); i += 10)
+                fractions[i] = Fraction(numeric_limits<int>::max(), 1);
+
+        measure("a * b, catching overflow_error", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                    {
+                        try
+                        {
+                            sum += (fractions[i - 1] * fractions[i]).getDenominator();
+                        }
+                        catch (const overflow_error &)
+                        {
+                            --sum;
+                        }
+                    }
+                    return sum; });
+        measure("checked_multiply(a, b)", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                    {
+                        Checked<Fraction> product = checked_multiply(fractions[i - 1], fractions[i]);
+                        sum += product ? product.value.getDenominator() : -1;
+                    }
+                    return sum; });
+    }
+
+    void bench_construction()
+    {
+        cout << "result construction (|n|, d <= 1000)" << endl;
+        vector<pair<int, int>> inputs = operands(1000, 1, 1000, 7);
+        for (auto &[num, den] : inputs)
+        {
+                int common = gcd(num, den);
+                num /= common;
+                den /= common;
+        }
+
+        // The checks and reduce() that operators skip by building their already
+        // normalized results through the private constructor
+        measure("Fraction(n, d) on reduced input", inputs.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const auto &[num, den] : inputs)
+                        sum += Fraction(num, den).getDenominator();
+                    return sum; });
+
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : inputs)
+                fractions.emplace_back(num, den);
+        measure("++a", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (Fraction fraction : fractions)
+                        sum += (++fraction).getNumerator();
+                    return sum; });
+        measure("a - b (same denominator)", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (const Fraction &fraction : fractions)
+                        sum += (fraction - Fraction(1, fraction.getDenominator())).getNumerator();
+                    return sum; });
+    }
+
+    // The Demo.cpp operators behind a call boundary, as they were when only objects/Fraction.o defined them
+    __attribute__((noinline)) Fraction call_add(const Fraction &num1, const Fraction &num2) { return num1 + num2; }
+    __attribute__((noinline)) Fraction call_subtract(const Fraction &num1, const Fraction &num2) { return num1 - num2; }
+    __attribute__((noinline)) Fraction call_multiply(const Fraction &num1, const Fraction &num2) { return num1 * num2; }
+    __attribute__((noinline)) Fraction call_divide(const Fraction &num1, const Fraction &num2) { return num1 / num2; }
+    __attribute__((noinline)) bool call_greater(const Fraction &num1, const Fraction &num2) { return num1 > num2; }
+    __attribute__((noinline)) bool call_greater_equal(const Fraction &num1, const Fraction &num2) { return num1 >= num2; }
+    __attribute__((noinline)) int call_numerator(const Fraction &fraction) { return fraction.getNumerator(); }
+
+    // Compare the numbers of `make bench`, `make bench_header_only` and `make bench_lto`:
+    // the out-of-line rows show what every operator paid before the core moved into the header.
+    void bench_mixed_expressions()
+    {
+        cout << "Demo.cpp expressions (|n|, d <= 100)" << endl;
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : operands(100, 1, 100, 10))
+                fractions.emplace_back(num == 0 ? 1 : num, den);
+
+        measure("Demo mix (a+b ... a>1.1), inline", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                    {
+                        const Fraction &a = fractions[i - 1];
+                        const Fraction &b = fractions[i];
+                        sum += (a + b).getNumerator() + (a - b).getNumerator() + (a * b).getNumerator() + (a / b).getNumerator();
+                        sum += (2.3 * b).getNumerator();
+                        Fraction c = a + b - 1;
+                        sum += (c >= b) + (a > 1.1) + c.getNumerator();
+                    }
+                    return sum; });
+        measure("Demo mix, out-of-line calls", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                    {
+                        const Fraction &a = fractions[i - 1];
+                        const Fraction &b = fractions[i];
+                        sum += call_numerator(call_add(a, b)) + call_numerator(call_subtract(a, b)) +
+                               call_numerator(call_multiply(a, b)) + call_numerator(call_divide(a, b));
+                        sum += call_numerator(call_multiply(2.3, b));
+                        Fraction c = call_subtract(call_add(a, b), 1);
+                        sum += call_greater_equal(c, b) + call_greater(a, 1.1) + call_numerator(c);
+                    }
+                    return sum; });
+        measure("a == b, a != b inline", fractions.size() - 1, [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 1; i < fractions.size(); ++i)
+                        sum += (fractions[i - 1] == fractions[i]) + (fractions[i] != fractions[0]);
+                    return sum; });
+    }
+
+    // The mixed-type paths of StudentTest2.cpp, against the old implicit BasicFraction(float) conversion
+    void bench_mixed_operands()
+    {
+        cout << "fraction op double (|n|, d <= 1000)" << endl;
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 11))
+                fractions.emplace_back(num, den);
+        const double values[] = {0.5, 2.3, -1.1, 2.421, 12.963, -3.141, 0.75, 4.321};
+        const size_t count = size(values);
+
+        measure("a + x via Fraction(float)", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        sum += (fractions[i] + Fraction(static_cast<float>(values[i % count]))).getNumerator();
+                    return sum; });
+        measure("a + x", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        sum += (fractions[i] + values[i % count]).getNumerator();
+                    return sum; });
+        measure("x * a via Fraction(float)", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        sum += (Fraction(static_cast<float>(values[i % count])) * fractions[i]).getNumerator();
+                    return sum; });
+        measure("x * a", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        sum += (values[i % count] * fractions[i]).getNumerator();
+                    return sum; });
+        measure("a > x, a == x via Fraction(float)", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                    {
+                        const Fraction converted(static_cast<float>(values[i % count]));
+                        sum += (fractions[i] > converted) + (fractions[i] == converted);
+                    }
+                    return sum; });
+        measure("a > x, a == x", fractions.size(), [&]
+                {
+                    long long sum = 0;
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        sum += (fractions[i] > values[i % count]) + (fractions[i] == values[i % count]);
+                    return sum; });
+    }
+
+    void bench_double_conversion()
+    {
+        cout << "double to Fraction64 (|x| <= 1000)" << endl;
+        mt19937_64 gen(12);
+        uniform_real_distribution<double> dist(-1000, 1000);
+        vector<double> values(SAMPLES);
+        for (double &value : values)
+                value = dist(gen);
+
+        measure("Fraction64(float), 3 digits", values.size(), [&]
+                {
+                    long long sum = 0;
+                    for (double value : values)
+                        sum += Fraction64(static_cast<float>(value)).getDenominator();
+                    return sum; });
+        measure("Fraction64::from_double_exact", values.size(), [&]
+                {
+                    long long sum = 0;
+                    for (double value : values)
+                        sum += Fraction64::from_double_exact(value).getDenominator();
+                    return sum; });
+        measure("Fraction::from_double(x, 1000)", values.size(), [&]
+                {
+                    long long sum = 0;
+                    for (double value : values)
+                        sum += Fraction::from_double(value, 1000).getDenominator();
+                    return sum; });
+        measure("Fraction::from_double(x, 1000000)", values.size(), [&]
+                {
+                    long long sum = 0;
+                    for (double value : values)
+                        sum += Fraction::from_double(value, 1000000).getDenominator();
+                    return sum; });
+    }
+
+    void bench_to_double()
+    {
+        cout << "fraction to double" << endl;
+        vector<Fraction> fractions;
+        for (const auto &[num, den] : operands(numeric_limits<int>::max(), 1, numeric_limits<int>::max(), 13))
+                fractions.emplace_back(num, den);
+        vector<Fraction64> wide_fractions;
+        mt19937_64 gen(14);
+        uniform_int_distribution<int64_t> wide(1, numeric_limits<int64_t>::max());
+        for (size_t i = 0; i < SAMPLES; ++i)
+                wide_fractions.emplace_back(wide(gen) - wide(gen), wide(gen));
+        vector<double> out(SAMPLES);
+
+        measure("Fraction, getters and a division", fractions.size(), [&]
+                {
+                    for (size_t i = 0; i < fractions.size(); ++i)
+                        out[i] = double(fractions[i].getNumerator()) / double(fractions[i].getDenominator());
+                    return static_cast<long long>(out[SAMPLES / 2]); });
+        measure("Fraction::to_double, array", fractions.size(), [&]
+                {
+                    Fraction::to_double(fractions, out);
+                    return static_cast<long long>(out[SAMPLES / 2]); });
+        measure("Fraction64::to_double, array", wide_fractions.size(), [&]
+                {
+                    Fraction64::to_double(wide_fractions, out);
+                    return static_cast<long long>(out[SAMPLES / 2]); });
+    }
+
+    // Element-wise kernels over arrays against the same loop over the scalar operators
+    void bench_batch()
+    {
+        cout << "batch arithmetic (|n|, d <= 1000)" << endl;
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 15))
+                lhs.emplace_back(num, den);
+        for (const auto &[num, den] : operands(1000, 1, 1000, 16))
+                rhs.emplace_back(num == 0 ? 1 : num, den);
+        vector<Fraction> out(lhs.size());
+        vector<int> order(lhs.size());
+
+        const pair<const char *, Fraction (*)(const Fraction &, const Fraction &)> scalar_operators[] = {
+            {"a + b", [](const Fraction &num1, const Fraction &num2) { return Fraction(num1 + num2); }},
+            {"a * b", [](const Fraction &num1, const Fraction &num2) { return Fraction(num1 * num2); }},
+            {"a / b", [](const Fraction &num1, const Fraction &num2) { return Fraction(num1 / num2); }},
+        };
+        const pair<const char *, void (*)(span<const Fraction>, span<const Fraction>, span<Fraction>)> batch_operators[] = {
+            {"a + b", Fraction::batch_add},
+            {"a * b", Fraction::batch_multiply},
+            {"a / b", Fraction::batch_divide},
+        };
+        for (size_t op = 0; op < size(scalar_operators); ++op)
+        {
+                measure(string("scalar loop  ") + scalar_operators[op].first, lhs.size(), [&]
+                        {
+                            for (size_t i = 0; i < lhs.size(); ++i)
+                                out[i] = scalar_operators[op].second(lhs[i], rhs[i]);
+                            return static_cast<long long>(out[SAMPLES / 2].getNumerator()); });
+                measure(string("batch        ") + batch_operators[op].first, lhs.size(), [&]
+                        {
+                            batch_operators[op].second(lhs, rhs, out);
+                            return static_cast<long long>(out[SAMPLES / 2].getNumerator()); });
+        }
+        measure("scalar loop  a * 3/7", lhs.size(), [&]
+                {
+                    for (size_t i = 0; i < lhs.size(); ++i)
+                        out[i] = lhs[i] * Fraction(3, 7);
+                    return static_cast<long long>(out[SAMPLES / 2].getNumerator()); });
+        measure("batch        a * 3/7", lhs.size(), [&]
+                {
+                    Fraction::batch_multiply(lhs, Fraction(3, 7), out);
+                    return static_cast<long long>(out[SAMPLES / 2].getNumerator()); });
+        measure("scalar loop  a <=> b", lhs.size(), [&]
+                {
+                    for (size_t i = 0; i < lhs.size(); ++i)
+                        order[i] = lhs[i] < rhs[i] ? -1 : (lhs[i] == rhs[i] ? 0 : 1);
+                    return static_cast<long long>(order[SAMPLES / 2]); });
+        measure("batch        a <=> b", lhs.size(), [&]
+                {
+                    Fraction::batch_compare(lhs, rhs, order);
+                    return static_cast<long long>(order[SAMPLES / 2]); });
+    }
+
+    // Column-wide passes over vector<Fraction> (interleaved terms) and FractionColumn (separate arrays)
+    void bench_column()
+    {
+        cout << "vector<Fraction> vs FractionColumn (|n|, d <= 1000)" << endl;
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 17))
+                lhs.emplace_back(num, 1000);
+        for (const auto &[num, den] : operands(1000, 1, 1000, 18))
+                rhs.emplace_back(num, den);
+        const FractionColumn left(lhs);
+        const FractionColumn right(rhs);
+        vector<int> order(lhs.size());
+        vector<double> doubles(lhs.size());
+
+        measure("vector  all denominators equal", lhs.size(), [&]
+                {
+                    bool common = true;
+                    for (const Fraction &fraction : lhs)
+                        common &= fraction.getDenominator() == lhs[0].getDenominator();
+                    return static_cast<long long>(common); });
+        measure("column  has_common_denominator", lhs.size(), [&]
+                { return static_cast<long long>(left.has_common_denominator()); });
+        measure("vector  batch_compare", lhs.size(), [&]
+                {
+                    Fraction::batch_compare(lhs, rhs, order);
+                    return static_cast<long long>(order[SAMPLES / 2]); });
+        measure("column  batch_compare", lhs.size(), [&]
+                {
+                    FractionColumn::batch_compare(left, right, order);
+                    return static_cast<long long>(order[SAMPLES / 2]); });
+        measure("vector  to_double", lhs.size(), [&]
+                {
+                    Fraction::to_double(rhs, doubles);
+                    return static_cast<long long>(doubles[SAMPLES / 2]); });
+        measure("column  to_double", lhs.size(), [&]
+                {
+                    right.to_double(doubles);
+                    return static_cast<long long>(doubles[SAMPLES / 2]); });
+    }
+
+    // The raw-term kernels at each instruction set the CPU supports, against operator< and operator*
+    void bench_simd()
+    {
+        cout << "SIMD kernels over int terms (|n|, d <= 1000)" << endl;
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 20))
+                lhs.emplace_back(num, den);
+        for (const auto &[num, den] : operands(1000, 1, 1000, 21))
+                rhs.emplace_back(num, den);
+        const FractionColumn left(lhs);
+        const FractionColumn right(rhs);
+        const int *num_1 = left.numerators().data();
+        const int *den_1 = left.denominators().data();
+        const int *num_2 = right.numerators().data();
+        const int *den_2 = right.denominators().data();
+        vector<int> order(lhs.size());
+        vector<int64_t> num_out(lhs.size());
+        vector<int64_t> den_out(lhs.size());
+
+        measure("scalar loop  a < b", lhs.size(), [&]
+                {
+                    for (size_t i = 0; i < lhs.size(); ++i)
+                        order[i] = lhs[i] < rhs[i];
+                    return static_cast<long long>(order[SAMPLES / 2]); });
+        measure("scalar loop  a * b (reduced)", lhs.size(), [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < lhs.size(); ++i)
+                        total += (lhs[i] * rhs[i]).getNumerator();
+                    return total; });
+        const pair<SimdLevel, const char *> levels[] = {
+            {SimdLevel::scalar, "scalar"}, {SimdLevel::sse41, "sse4.1"}, {SimdLevel::avx2, "avx2  "}};
+        for (const auto &[level, level_name] : levels)
+        {
+                if (level > simd_level())
+                    continue;
+                const string prefix = level_name;
+                measure(prefix + "       compare_terms", lhs.size(), [&]
+                        {
+                            compare_terms(num_1, den_1, num_2, den_2, order.data(), lhs.size(), level);
+                            return static_cast<long long>(order[SAMPLES / 2]); });
+                measure(prefix + "       multiply_terms (unreduced)", lhs.size(), [&]
+                        {
+                            multiply_terms(num_1, den_1, num_2, den_2, num_out.data(), den_out.data(), lhs.size(), level);
+                            return static_cast<long long>(num_out[SAMPLES / 2]); });
+                measure(prefix + "       scale_terms by 3/7", lhs.size(), [&]
+                        {
+                            scale_terms(num_1, den_1, 3, 7, num_out.data(), den_out.data(), lhs.size(), level);
+                            return static_cast<long long>(den_out[SAMPLES / 2]); });
+        }
+    }
+
+    // Bulk normalization of unreduced products: the lockstep gcd at each level, and the
+    // multiply-then-reduce pipeline against the column's own reducing multiply
+    void bench_batch_reduce()
+    {
+        cout << "Batch reduce of unreduced products (|n|, d <= 1000)" << endl;
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 22))
+                lhs.emplace_back(num, den);
+        for (const auto &[num, den] : operands(1000, 1, 1000, 23))
+                rhs.emplace_back(num, den);
+        const FractionColumn left(lhs);
+        const FractionColumn right(rhs);
+        vector<int64_t> products_num(lhs.size());
+        vector<int64_t> products_den(lhs.size());
+        multiply_terms(left.numerators().data(), left.denominators().data(), right.numerators().data(), right.denominators().data(),
+                       products_num.data(), products_den.data(), lhs.size());
+        vector<int64_t> num(lhs.size());
+        vector<int64_t> den(lhs.size());
+        FractionColumn result;
+
+        // reduce_terms has no SSE4.1 kernel
+        const pair<SimdLevel, const char *> levels[] = {{SimdLevel::scalar, "scalar"}, {SimdLevel::avx2, "avx2  "}};
+        for (const auto &[level, level_name] : levels)
+        {
+                if (level > simd_level())
+                    continue;
+                measure(string(level_name) + "  reduce_terms", lhs.size(), [&]
+                        {
+                            num = products_num;
+                            den = products_den;
+                            reduce_terms(num.data(), den.data(), lhs.size(), level);
+                            return static_cast<long long>(num[SAMPLES / 2]); });
+        }
+        measure("column  batch_multiply", lhs.size(), [&]
+                {
+                    FractionColumn::batch_multiply(left, right, result);
+                    return static_cast<long long>(result[SAMPLES / 2].getNumerator()); });
+        measure("column  multiply_terms + assign_unreduced", lhs.size(), [&]
+                {
+                    multiply_terms(left.numerators().data(), left.denominators().data(), right.numerators().data(),
+                                   right.denominators().data(), num.data(), den.data(), lhs.size());
+                    result.assign_unreduced(num, den);
+                    return static_cast<long long>(result[SAMPLES / 2].getNumerator()); });
+    }
+
+    // Expression chains with eager reduction (Fraction) and reduction deferred to the final value (LazyFraction)
+    void bench_lazy()
+    {
+        cout << "Eager vs lazy normalization, value observed once per chain" << endl;
+        vector<Fraction> eager;
+        for (const auto &[num, den] : operands(1000, 1, 1000, 24))
+                eager.emplace_back(num | 1, den);
+        vector<LazyFraction> lazy(eager.begin(), eager.end());
+        vector<Fraction> sixteenths;
+        for (const auto &[num, den] : operands(15, 1, 1, 25))
+                sixteenths.emplace_back(num, 16);
+        vector<LazyFraction> lazy_sixteenths(sixteenths.begin(), sixteenths.end());
+
+        measure("Fraction      a + b - 1", eager.size() - 1, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 1 < eager.size(); ++i)
+                        total += (eager[i] + eager[i + 1] - 1).getNumerator();
+                    return total; });
+        measure("LazyFraction  a + b - 1", lazy.size() - 1, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 1 < lazy.size(); ++i)
+                        total += (lazy[i] + lazy[i + 1] - 1).getNumerator();
+                    return total; });
+        measure("Fraction      a * b / c", eager.size() - 2, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 2 < eager.size(); ++i)
+                        total += (eager[i] * eager[i + 1] / eager[i + 2]).getNumerator();
+                    return total; });
+        measure("LazyFraction  a * b / c", lazy.size() - 2, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 2 < lazy.size(); ++i)
+                        total += (lazy[i] * lazy[i + 1] / lazy[i + 2]).getNumerator();
+                    return total; });
+        measure("Fraction      sum of 8 n/16", sixteenths.size() / 8, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 8 <= sixteenths.size(); i += 8)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + 8; ++j)
+                            sum = sum + sixteenths[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+        measure("LazyFraction  sum of 8 n/16", lazy_sixteenths.size() / 8, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + 8 <= lazy_sixteenths.size(); i += 8)
+                    {
+                        LazyFraction sum = lazy_sixteenths[i];
+                        for (size_t j = i + 1; j < i + 8; ++j)
+                            sum = sum + lazy_sixteenths[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+    }
+
+    // 3-, 5- and 10-term expressions evaluated operator by operator and fused into one pass
+    void bench_fused_expressions()
+    {
+        cout << "Eager vs fused expressions (|n| <= 50, d <= 12)" << endl;
+        vector<Fraction> f;
+        for (const auto &[num, den] : operands(50, 1, 12, 26))
+                f.emplace_back(num, den);
+        const size_t count = f.size() - 10;
+
+        measure("eager  a + b - 1", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += (f[i] + f[i + 1] - 1).getNumerator();
+                    return total; });
+        measure("fused  a + b - 1", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += Fraction(fuse(f[i]) + f[i + 1] - 1).getNumerator();
+                    return total; });
+        measure("eager  3 terms a + b - c", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += (f[i] + f[i + 1] - f[i + 2]).getNumerator();
+                    return total; });
+        measure("fused  3 terms a + b - c", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += Fraction(fuse(f[i]) + f[i + 1] - f[i + 2]).getNumerator();
+                    return total; });
+        measure("eager  5 terms a * b + c * d - e", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += (f[i] * f[i + 1] + f[i + 2] * f[i + 3] - f[i + 4]).getNumerator();
+                    return total; });
+        measure("fused  5 terms a * b + c * d - e", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += Fraction(fuse(f[i]) * f[i + 1] + f[i + 2] * f[i + 3] - f[i + 4]).getNumerator();
+                    return total; });
+        measure("eager  10-term sum", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += (f[i] + f[i + 1] + f[i + 2] + f[i + 3] + f[i + 4] + f[i + 5] + f[i + 6] + f[i + 7] + f[i + 8] + f[i + 9]).getNumerator();
+                    return total; });
+        measure("fused  10-term sum", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i < count; ++i)
+                        total += Fraction(fuse(f[i]) + f[i + 1] + f[i + 2] + f[i + 3] + f[i + 4] + f[i + 5] + f[i + 6] + f[i + 7] + f[i + 8] + f[i + 9]).getNumerator();
+                    return total; });
+    }
+
+    // Dot products and Horner's rule with a * b + c, fma and the compound operators
+    void bench_fma()
+    {
+        cout << "Multiply-add (|n| <= 20, d <= 6)" << endl;
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (const auto &[num, den] : operands(20, 1, 6, 27))
+                lhs.emplace_back(num, den);
+        for (const auto &[num, den] : operands(20, 1, 6, 28))
+                rhs.emplace_back(num, den);
+        // Short dot products and polynomials keep the accumulator within int
+        const size_t length = 4;
+        const size_t count = lhs.size() / length;
+
+        measure("dot product  sum = sum + a * b", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= lhs.size(); i += length)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum = sum + lhs[j] * rhs[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+        measure("dot product  sum += a * b", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= lhs.size(); i += length)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum += lhs[j] * rhs[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+        measure("dot product  sum = fma(a, b, sum)", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= lhs.size(); i += length)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum = fma(lhs[j], rhs[j], sum);
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+        measure("Horner  r = r * x + c", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= lhs.size(); i += length)
+                    {
+                        Fraction result = lhs[i];
+                        for (size_t j = i + 1; j < i + length; ++j)
+                            result = result * rhs[i] + lhs[j];
+                        total += result.getNumerator();
+                    }
+                    return total; });
+        measure("Horner  r = fma(r, x, c)", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= lhs.size(); i += length)
+                    {
+                        Fraction result = lhs[i];
+                        for (size_t j = i + 1; j < i + length; ++j)
+                            result = fma(result, rhs[i], lhs[j]);
+                        total += result.getNumerator();
+                    }
+                    return total; });
+    }
+
+    // Accumulation with sum = sum + x against sum += x, timed per sum of length terms; with BigFraction the terms
+    // outgrow 64 bits and live on the heap
+    void bench_compound()
+    {
+        cout << "Compound assignment (|n| <= 20, d <= 6)" << endl;
+        vector<Fraction> small;
+        for (const auto &[num, den] : operands(20, 1, 6, 29))
+                small.emplace_back(num, den);
+        const size_t length = 4;
+        const size_t count = small.size() / length;
+
+        measure("Fraction     sum = sum + x", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= small.size(); i += length)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum = sum + small[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+        measure("Fraction     sum += x", count, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= small.size(); i += length)
+                    {
+                        Fraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum += small[j];
+                        total += sum.getNumerator();
+                    }
+                    return total; });
+
+        // Terms near 2^100 keep every sum in heap limbs
+        vector<BigFraction> big;
+        const BigInt offset(__int128{1} << 100);
+        for (const Fraction &fraction : small)
+                big.emplace_back(offset + BigInt(fraction.getNumerator()), BigInt(fraction.getDenominator()));
+        const size_t big_count = big.size() / 100;
+        const size_t big_sums = big_count / length;
+
+        measure("BigFraction  sum = sum + x", big_sums, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= big_count; i += length)
+                    {
+                        BigFraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum = sum + big[j];
+                        total += sum.getDenominator() == BigInt(1);
+                    }
+                    return total; });
+        measure("BigFraction  sum += x", big_sums, [&]
+                {
+                    long long total = 0;
+                    for (size_t i = 0; i + length <= big_count; i += length)
+                    {
+                        BigFraction sum;
+                        for (size_t j = i; j < i + length; ++j)
+                            sum += big[j];
+                        total += sum.getDenominator() == BigInt(1);
+                    }
+                    return total; });
+    }
+}
+
+int main()
+{
+    bench_gcd();
+    bench_backing_types();
+    bench_construction();
+    bench_overflow_checks();
+    bench_error_handling();
+    bench_mixed_expressions();
+    bench_mixed_operands();
+    bench_double_conversion();
+    bench_to_double();
+    bench_batch();
+    bench_column();
+    bench_simd();
+    bench_batch_reduce();
+    bench_lazy();
+    bench_fused_expressions();
+    bench_fma();
+    bench_compound();
+    return 0;
+}
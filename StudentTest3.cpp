@@ -0,0 +1,1519 @@
+#include "doctest.h"
+#include "sources/Fraction.hpp"
+#include "sources/FractionColumn.hpp"
+#include "sources/FractionExpression.hpp"
+#include "sources/FractionSimd.hpp"
+#include "sources/LazyFraction.hpp"
+#include "sources/Gcd.hpp"
+#include "sources/Overflow.hpp"
+#include "sources/OverflowPolicy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+using namespace ariel;
+
+TEST_SUITE("gcd engine") {
+
+    TEST_CASE("fraction_gcd agrees with std::gcd") {
+        for (int num1 = -64; num1 <= 64; ++num1)
+        {
+            for (int num2 = -64; num2 <= 64; ++num2)
+            {
+                CHECK_EQ(fraction_gcd(num1, num2), gcd(num1, num2));
+            }
+        }
+        CHECK_EQ(fraction_gcd(numeric_limits<int>::max(), numeric_limits<int>::max() - 100), 1);
+        CHECK_EQ(fraction_gcd(numeric_limits<int>::min(), 6), 2);
+        CHECK_EQ(fraction_gcd(123456789LL * 1000000, 3000000LL), 3000000LL);
+    }
+
+    TEST_CASE("Power of two and unit operands") {
+        CHECK_EQ(binary_gcd(1u, 999u), 1u);
+        CHECK_EQ(binary_gcd(64u, 96u), 32u);
+        CHECK_EQ(binary_gcd(12u, 1024u), 4u);
+        CHECK_EQ(binary_gcd(0u, 1024u), 1024u);
+    }
+}
+
+TEST_SUITE("Wider backing integer types") {
+
+    TEST_CASE("Fraction keeps int storage") {
+        CHECK(is_same_v<Fraction::value_type, int>);
+        CHECK(is_same_v<decltype(Fraction64{1, 2}.getNumerator()), int64_t>);
+    }
+
+    TEST_CASE("Fraction64 holds products that overflow int") {
+        int max_int = numeric_limits<int>::max();
+        CHECK_THROWS_AS(Fraction(max_int, 1) * Fraction(max_int - 100, 3), overflow_error);
+        Fraction64 product = Fraction64(max_int, 1) * Fraction64(max_int - 100, 3);
+        CHECK_EQ(product.getNumerator(), int64_t{max_int} * (max_int - 100) / 3);
+        CHECK_EQ(product.getDenominator(), 1);
+        CHECK_EQ(Fraction64{12345, 23456} * Fraction64{34567, 45678}, Fraction64{426729615, 1071423168});
+        CHECK_THROWS_AS(Fraction64(numeric_limits<int64_t>::max(), 1) + Fraction64(1, 1), overflow_error);
+    }
+
+    TEST_CASE("Fraction128 arithmetic and streams") {
+        Fraction128 big(numeric_limits<int64_t>::max(), 1);
+        Fraction128 square = big * big;
+        stringstream out;
+        out << square << " " << Fraction128{-3, 6};
+        CHECK_EQ(out.str(), "85070591730234615847396907784232501249/1 -1/2");
+
+        stringstream in("85070591730234615847396907784232501249 1 -3 6");
+        Fraction128 parsed;
+        Fraction128 half;
+        in >> parsed >> half;
+        CHECK_EQ(parsed, square);
+        CHECK_EQ(half, Fraction128{1, -2});
+        CHECK(Fraction128{1, 3} < Fraction128{1, 2});
+        CHECK_EQ(Fraction128{1, 2} + 0.25, Fraction128{3, 4});
+    }
+}
+
+TEST_SUITE("BigInt and BigFraction") {
+
+    TEST_CASE("BigInt stays inline until it outgrows one limb") {
+        BigInt small(numeric_limits<long long>::max());
+        CHECK(small.is_small());
+        BigInt grown = small * BigInt(4);
+        CHECK_FALSE(grown.is_small());
+        CHECK_EQ(grown.to_string(), "36893488147419103228");
+        CHECK(((grown / BigInt(4)) == small));
+        CHECK((grown / BigInt(4)).is_small());
+        CHECK_EQ((-grown + BigInt(1)).to_string(), "-36893488147419103227");
+
+        // 128-bit values only spill to the heap when their magnitude needs the second limb
+        CHECK(BigInt(__int128{-5}).is_small());
+        CHECK(BigInt(static_cast<__int128>(numeric_limits<uint64_t>::max())).is_small());
+        CHECK_FALSE(BigInt(static_cast<__int128>(numeric_limits<uint64_t>::max()) + 1).is_small());
+        CHECK(((BigInt(__int128{-5}) == BigInt(-5))));
+    }
+
+    TEST_CASE("BigInt inline fast paths agree with the general code") {
+        const BigInt max_limb(static_cast<__int128>(numeric_limits<uint64_t>::max()));
+        const BigInt two_limbs = max_limb * max_limb;
+        CHECK_EQ((max_limb + BigInt(1)).to_string(), "18446744073709551616");
+        CHECK_EQ((BigInt(1) - max_limb - BigInt(2)).to_string(), "-18446744073709551616");
+        CHECK_EQ((BigInt(-7) - BigInt(-9)).to_string(), "2");
+        CHECK_EQ((BigInt(-9) + BigInt(7)).to_string(), "-2");
+        CHECK_EQ((BigInt(7) * BigInt(-3)).to_string(), "-21");
+        CHECK_EQ((BigInt(-7) / BigInt(2)).to_string(), "-3");
+        CHECK_EQ((BigInt(-7) % BigInt(2)).to_string(), "-1");
+        CHECK_EQ((BigInt(0) * BigInt(-3)).to_string(), "0");
+        CHECK((BigInt(-3) < BigInt(-2)));
+        CHECK_FALSE((BigInt(-2) < BigInt(-3)));
+        CHECK((BigInt(-1) < max_limb));
+
+        // One heap operand and one single-limb operand
+        CHECK(((two_limbs % BigInt(1000)) == BigInt(225)));
+        CHECK(((-two_limbs % BigInt(1000)) == BigInt(-225)));
+        CHECK((fraction_gcd(two_limbs, BigInt(-15)) == BigInt(15)));
+        CHECK((fraction_gcd(BigInt(0), -two_limbs) == two_limbs));
+        CHECK((fraction_gcd(two_limbs * BigInt(4), BigInt(6)) == BigInt(6)));
+        CHECK_THROWS_AS(two_limbs / BigInt(0), runtime_error);
+        CHECK_THROWS_AS(BigInt(1) % BigInt(0), runtime_error);
+    }
+
+    TEST_CASE("BigInt compound operators agree with the binary operators") {
+        // Values of zero to three limbs, so that sums and differences cross between inline and heap storage
+        mt19937_64 gen(3);
+        auto random_value = [&]
+        {
+            BigInt value(static_cast<__int128>(gen() >> (gen() % 64)));
+            for (uint64_t limbs = gen() % 3; limbs > 0; --limbs)
+                value = value * BigInt(static_cast<__int128>(numeric_limits<uint64_t>::max())) + BigInt(static_cast<__int128>(gen()));
+            return gen() % 2 == 0 ? value : -value;
+        };
+        for (int round = 0; round < 2000; ++round)
+        {
+            const BigInt a = random_value();
+            const BigInt b = round % 4 == 0 ? -a + BigInt(static_cast<long long>(gen() % 5) - 2) : random_value();
+            BigInt sum = a, difference = a, product = a, quotient = a;
+            sum += b;
+            difference -= b;
+            product *= b;
+            CHECK(((sum == a + b) && (difference == a - b) && (product == a * b)));
+            if (!b.is_zero())
+            {
+                quotient /= b;
+                CHECK((quotient == a / b));
+            }
+        }
+
+        BigInt self = BigInt(__int128{1} << 100) + BigInt(5);
+        const BigInt original = self;
+        self += self;
+        CHECK((self == original * BigInt(2)));
+        self -= self;
+        CHECK(self.is_zero());
+        CHECK_FALSE(self.is_negative());
+        self = original;
+        self *= self;
+        CHECK((self == original * original));
+        self /= self;
+        CHECK((self == BigInt(1)));
+        CHECK_THROWS_AS(self /= BigInt(0), runtime_error);
+    }
+
+    TEST_CASE("BigInt division identities") {
+        // 3^200 and 7^50 exercise multi-limb long division
+        BigInt power3(1);
+        BigInt power7(1);
+        for (int i = 0; i < 200; ++i)
+            power3 *= BigInt(3);
+        for (int i = 0; i < 50; ++i)
+            power7 *= BigInt(7);
+        BigInt quotient = power3 / power7;
+        BigInt remainder = power3 % power7;
+        CHECK(((quotient * power7 + remainder) == power3));
+        CHECK((remainder < power7));
+        CHECK(((-power3) / power7 == -quotient));
+        CHECK((fraction_gcd(power3 * BigInt(14), power7 * BigInt(9)) == BigInt(63)));
+
+        stringstream text(power3.to_string());
+        BigInt parsed;
+        text >> parsed;
+        CHECK((parsed == power3));
+    }
+
+    TEST_CASE("BigFraction accumulates without overflow") {
+        // The harmonic sum overflows int after a couple of dozen terms
+        CHECK_THROWS_AS(
+            {
+                Fraction sum;
+                for (int i = 1; i <= 100; ++i)
+                    sum = sum + Fraction(1, i);
+            },
+            overflow_error);
+
+        BigFraction sum;
+        for (int i = 1; i <= 1000; ++i)
+            sum = sum + BigFraction(1, i);
+        BigFraction back = sum;
+        for (int i = 1000; i >= 1; --i)
+            back = back - BigFraction(1, i);
+        CHECK_EQ(back, BigFraction());
+        CHECK(sum > BigFraction(7, 1));
+        CHECK(sum < BigFraction(15, 2));
+        CHECK_FALSE(sum.getDenominator().is_small());
+
+        CHECK_EQ(BigFraction(2, 3) * 0.5, BigFraction(1, 3));
+        stringstream out;
+        out << BigFraction(numeric_limits<int>::max(), 1) * BigFraction(numeric_limits<int>::max(), 3);
+        CHECK_EQ(out.str(), "4611686014132420609/3");
+    }
+}
+
+TEST_SUITE("Overflow-free arithmetic") {
+
+    TEST_CASE("Addition and subtraction divide by gcd(d1, d2) first") {
+        // d1 * d2 overflows int, but the reduced result fits
+        CHECK_EQ(Fraction(1, 196608) + Fraction(1, 327680), Fraction(1, 122880));
+        CHECK_EQ(Fraction(1, 196608) - Fraction(1, 327680), Fraction(1, 491520));
+        CHECK_EQ(Fraction(1, 46341) + Fraction(46340, 46341), Fraction(1, 1));
+
+        CHECK_EQ(Fraction(1, 6) + Fraction(1, 3), Fraction(1, 2));
+        CHECK_EQ(Fraction(5, 12) - Fraction(1, 12), Fraction(1, 3));
+        CHECK_EQ(Fraction(3, 4) - Fraction(3, 4), Fraction(0, 1));
+        CHECK_EQ((Fraction(3, 4) - Fraction(3, 4)).getDenominator(), 1);
+
+        int max_int = numeric_limits<int>::max();
+        CHECK_THROWS_AS(Fraction(1, max_int) + Fraction(1, max_int - 1), overflow_error);
+    }
+
+    TEST_CASE("Intermediate terms that overflow are recomputed wider") {
+        const int max_int = numeric_limits<int>::max();
+        // n1 * (d2 / g) op n2 * (d1 / g) overflows int although the reduced result fits
+        CHECK_EQ(Fraction(2, 3) + Fraction(max_int, 3), Fraction(715827883, 1));
+        CHECK_EQ(Fraction(max_int, 8) - Fraction(553264145, 3), Fraction(2016337781, 24));
+        CHECK_EQ(checked_add(Fraction(2, 3), Fraction(max_int, 3)).value, Fraction(715827883, 1));
+        CHECK_THROWS_AS(Fraction(max_int, 3) + Fraction(max_int, 3), overflow_error);
+
+        const int64_t max_64 = numeric_limits<int64_t>::max();
+        CHECK_EQ(Fraction64(2, 3) + Fraction64(max_64, 3), Fraction64(max_64 / 3 + 1, 1));
+        CHECK_THROWS_AS(Fraction64(max_64, 3) + Fraction64(max_64, 3), overflow_error);
+
+        // 2^127 + 1 is a multiple of 3; Fraction128 recomputes in BigInt
+        const __int128 max_128 = numeric_limits<__int128>::max();
+        CHECK_EQ(Fraction128(2, 3) + Fraction128(max_128, 3), Fraction128(max_128 / 3 + 1, 1));
+        CHECK_EQ(Fraction128(-2, 3) - Fraction128(max_128, 3), Fraction128(-(max_128 / 3) - 1, 1));
+        CHECK_THROWS_AS(Fraction128(max_128, 3) + Fraction128(max_128, 3), overflow_error);
+    }
+
+    TEST_CASE("Sums near the limits agree with BigFraction and the batch kernels") {
+        mt19937 gen(4);
+        const int max_int = numeric_limits<int>::max();
+        uniform_int_distribution<int> num(-max_int, max_int);
+        uniform_int_distribution<int> den(1, 24);
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (int round = 0; round < 2000; ++round)
+        {
+            lhs.emplace_back(num(gen), den(gen));
+            rhs.emplace_back(num(gen), den(gen));
+        }
+        const BigInt max_big(max_int);
+        for (const char op : {'+', '-'})
+        {
+            for (size_t i = 0; i < lhs.size(); ++i)
+            {
+                const BigFraction big_1(BigInt(lhs[i].getNumerator()), BigInt(lhs[i].getDenominator()));
+                const BigFraction big_2(BigInt(rhs[i].getNumerator()), BigInt(rhs[i].getDenominator()));
+                const BigFraction exact = op == '+' ? big_1 + big_2 : big_1 - big_2;
+                const bool fits = exact.getNumerator() <= max_big && exact.getNumerator() >= -max_big - BigInt(1) && exact.getDenominator() <= max_big;
+                const Checked<Fraction> result = op == '+' ? checked_add(lhs[i], rhs[i]) : checked_subtract(lhs[i], rhs[i]);
+                CHECK_EQ(result.ok(), fits);
+                if (fits && result.ok())
+                {
+                    CHECK_EQ(BigInt(result.value.getNumerator()), exact.getNumerator());
+                    CHECK_EQ(BigInt(result.value.getDenominator()), exact.getDenominator());
+                    vector<Fraction> out(1);
+                    if (op == '+')
+                        Fraction::batch_add(span(lhs).subspan(i, 1), span(rhs).subspan(i, 1), out);
+                    else
+                        Fraction::batch_subtract(span(lhs).subspan(i, 1), span(rhs).subspan(i, 1), out);
+                    CHECK_EQ(out[0], result.value);
+                }
+            }
+        }
+    }
+}
+
+TEST_SUITE("Cross-reduced multiplication and division") {
+
+    TEST_CASE("Products are cancelled before multiplying") {
+        int max_int = numeric_limits<int>::max();
+        CHECK_EQ(Fraction(65536, 3) * Fraction(9, 131072), Fraction(3, 2));
+        CHECK_EQ(Fraction(max_int, 2) * Fraction(2, max_int), Fraction(1, 1));
+        CHECK_EQ(Fraction(max_int, 2) / Fraction(max_int, 4), Fraction(2, 1));
+        CHECK_EQ(Fraction(0, 5) * Fraction(7, 3), Fraction(0, 1));
+        CHECK_EQ((Fraction(0, 5) * Fraction(7, 3)).getDenominator(), 1);
+        CHECK_EQ(Fraction(3, 4) / Fraction(-9, 8), Fraction(-2, 3));
+        CHECK_EQ((Fraction(3, 4) / Fraction(-9, 8)).getDenominator(), 3);
+        CHECK_THROWS_AS(Fraction(1, 1) / Fraction(numeric_limits<int>::min(), 1), overflow_error);
+        CHECK_THROWS_AS(Fraction(max_int, 1) * Fraction(max_int, 3), overflow_error);
+    }
+
+    TEST_CASE("A negative divisor's sign is applied before multiplying") {
+        int min_int = numeric_limits<int>::min();
+        CHECK_EQ(Fraction(4, 3) / Fraction(-1, 536870912), Fraction(min_int, 3));
+        CHECK_EQ((Fraction(4, 3) / Fraction(-1, 536870912)).getNumerator(), min_int);
+        CHECK_EQ(Fraction(-1, 1) / Fraction(-1, numeric_limits<int>::max()), Fraction(numeric_limits<int>::max(), 1));
+        CHECK_EQ(Fraction64(4, 3) / Fraction64(-1, int64_t(1) << 61), Fraction64(numeric_limits<int64_t>::min(), 3));
+        CHECK_THROWS_AS(Fraction(min_int, 1) / Fraction(-1, 1), overflow_error);
+        CHECK_THROWS_AS(Fraction(min_int, 3) / Fraction(-1, 2), overflow_error);
+    }
+}
+
+TEST_SUITE("Normalized results") {
+
+    TEST_CASE("Operators return canonical fractions without a second reduction") {
+        Fraction sum = Fraction(1, 6) + Fraction(1, 3);
+        CHECK(((sum.getNumerator() == 1) && (sum.getDenominator() == 2)));
+        Fraction zero = Fraction(5, 12) - Fraction(10, 24);
+        CHECK(((zero.getNumerator() == 0) && (zero.getDenominator() == 1)));
+
+        Fraction value(-7, 3);
+        ++value;
+        CHECK(((value.getNumerator() == -4) && (value.getDenominator() == 3)));
+        --value;
+        --value;
+        CHECK(((value.getNumerator() == -10) && (value.getDenominator() == 3)));
+
+        Fraction largest(numeric_limits<int>::max(), 1);
+        CHECK_THROWS_AS(++largest, overflow_error);
+        CHECK_EQ(largest, Fraction(numeric_limits<int>::max(), 1));
+    }
+}
+
+TEST_SUITE("Checked arithmetic primitives") {
+
+    TEST_CASE("Overflow builtins per operation") {
+        int max_int = numeric_limits<int>::max();
+        int min_int = numeric_limits<int>::min();
+        int result = 0;
+        CHECK_FALSE(add_overflow(max_int - 1, 1, result));
+        CHECK_EQ(result, max_int);
+        CHECK(add_overflow(max_int, 1, result));
+        CHECK(subtract_overflow(0, min_int, result));
+        CHECK(multiply_overflow(65536, 32768, result));
+        CHECK_FALSE(multiply_overflow(-65536, 32768, result));
+        CHECK_EQ(result, min_int);
+
+        CHECK_EQ(overflow_check_multiply(46340, 46340), 2147395600);
+        CHECK_THROWS_AS(overflow_check_multiply(46341, 46341), overflow_error);
+        CHECK_THROWS_AS(overflow_check_add(numeric_limits<int64_t>::max(), int64_t{1}), overflow_error);
+        CHECK_THROWS_AS(overflow_check_subtract(numeric_limits<__int128>::min(), __int128{1}), overflow_error);
+        CHECK_NOTHROW(overflow_check_multiply(BigInt(numeric_limits<long long>::max()), BigInt(numeric_limits<long long>::max())));
+    }
+}
+
+TEST_SUITE("Non-throwing checked API") {
+
+    TEST_CASE("Failures are reported instead of thrown") {
+        int max_int = numeric_limits<int>::max();
+        Checked<Fraction> sum = checked_add(Fraction(1, 2), Fraction(1, 3));
+        CHECK(sum.ok());
+        CHECK_EQ(sum.value, Fraction(5, 6));
+
+        CHECK_NOTHROW(checked_add(Fraction(max_int, 1), Fraction(1, 1)));
+        CHECK_EQ(checked_add(Fraction(max_int, 1), Fraction(1, 1)).error, FractionError::overflow);
+        CHECK_EQ(checked_subtract(Fraction(-max_int, 1), Fraction(2, 1)).error, FractionError::overflow);
+        CHECK_EQ(checked_multiply(Fraction(max_int, 1), Fraction(2, 1)).error, FractionError::overflow);
+        CHECK_EQ(checked_divide(Fraction(1, 2), Fraction(0, 1)).error, FractionError::division_by_zero);
+        CHECK_FALSE(checked_divide(Fraction(1, 2), Fraction(0, 1)));
+        CHECK_EQ(checked_divide(Fraction(1, 2), 0.25).value, Fraction(2, 1));
+
+        CHECK_EQ(Fraction::checked_create(3, 0).error, FractionError::zero_denominator);
+        CHECK_EQ(Fraction::checked_create(1, numeric_limits<int>::min()).error, FractionError::overflow);
+        CHECK_EQ(Fraction::checked_create(4, -6).value, Fraction(-2, 3));
+        CHECK_EQ(Fraction(2, numeric_limits<int>::min()), Fraction(-1, 1073741824));
+    }
+
+    TEST_CASE("Throwing API keeps its exception types") {
+        CHECK_THROWS_AS(Fraction(1, 0), invalid_argument);
+        CHECK_THROWS_AS(Fraction(1, 2) / Fraction(0, 1), runtime_error);
+        CHECK_THROWS_AS(Fraction(numeric_limits<int>::max(), 1) + Fraction(1, 1), overflow_error);
+    }
+}
+
+TEST_SUITE("Overflow policies") {
+
+    TEST_CASE("throw_error behaves like the operators") {
+        int max_int = numeric_limits<int>::max();
+        CHECK_EQ(add<OverflowPolicy::throw_error>(Fraction(1, 2), Fraction(1, 3)), Fraction(5, 6));
+        CHECK_THROWS_AS(multiply<OverflowPolicy::throw_error>(Fraction(max_int, 1), Fraction(3, 1)), overflow_error);
+        CHECK_THROWS_AS(divide<OverflowPolicy::saturate>(Fraction(1, 2), Fraction(0, 1)), runtime_error);
+    }
+
+    TEST_CASE("saturate clamps or rounds instead of throwing") {
+        int max_int = numeric_limits<int>::max();
+        int min_int = numeric_limits<int>::min();
+        CHECK_EQ(multiply<OverflowPolicy::saturate>(Fraction(max_int, 1), Fraction(3, 1)), Fraction(max_int, 1));
+        CHECK_EQ(subtract<OverflowPolicy::saturate>(Fraction(min_int, 1), Fraction(1, 1)), Fraction(min_int, 1));
+        CHECK_EQ(add<OverflowPolicy::saturate>(Fraction(1, 4), Fraction(1, 4)), Fraction(1, 2));
+
+        // 1/p + 1/q with large primes p and q: in range, but the exact denominator p * q does not fit
+        Fraction near = add<OverflowPolicy::saturate>(Fraction(1, 2147483629), Fraction(1, 2147483587));
+        Fraction128 exact = Fraction128(1, 2147483629) + Fraction128(1, 2147483587);
+        Fraction128 error = Fraction128(near) - exact;
+        CHECK(error.getNumerator() * 1000000 < error.getDenominator());
+        CHECK(error.getNumerator() * -1000000 < error.getDenominator());
+
+        CHECK_EQ(near, Fraction(1, 1073741804));
+        CHECK_EQ(add<OverflowPolicy::saturate>(Fraction(-1, 2147483629), Fraction(-1, 2147483587)), Fraction(-1, 1073741804));
+    }
+
+    TEST_CASE("saturate compares distances when the semiconvergent takes half the term") {
+        // [0; 2, 2147483646, ...]: the last convergent is 1/2 and the semiconvergent 1073741823/2147483647
+        // takes exactly half of the term 2147483646, so the rest of the expansion decides
+        CHECK_EQ(saturate<int>(Fraction64(6442450939, 12884901881)), Fraction(1073741823, 2147483647));
+        CHECK_EQ(saturate<int>(Fraction64(-6442450939, 12884901881)), Fraction(-1073741823, 2147483647));
+        CHECK_EQ(saturate<int>(Fraction64(6442450940, 12884901883)), Fraction(1, 2));
+        // Equally close: the smaller denominator is kept
+        CHECK_EQ(saturate<int>(Fraction64(4294967293, 8589934588)), Fraction(1, 2));
+    }
+
+    TEST_CASE("promote returns the wider type") {
+        int max_int = numeric_limits<int>::max();
+        Fraction64 product = multiply<OverflowPolicy::promote>(Fraction(max_int, 1), Fraction(3, 1));
+        CHECK_EQ(product, Fraction64(int64_t{max_int} * 3, 1));
+        CHECK_EQ(add<OverflowPolicy::promote>(Fraction(1, 2), Fraction(1, 2)), Fraction64(1, 1));
+
+        Fraction128 big = multiply<OverflowPolicy::promote>(Fraction64(numeric_limits<int64_t>::max(), 1), Fraction64(2, 1));
+        CHECK_EQ(big.getNumerator(), __int128{numeric_limits<int64_t>::max()} * 2);
+        BigFraction huge = multiply<OverflowPolicy::promote>(big, big);
+        CHECK_FALSE(huge.getNumerator().is_small());
+    }
+}
+
+TEST_SUITE("Compile-time fractions") {
+
+    // Evaluated by the compiler: a failure here is a build error
+    constexpr Fraction half(1, 2);
+    constexpr Fraction third(-2, -6);
+    static_assert(third.getNumerator() == 1 && third.getDenominator() == 3);
+    static_assert(half + third == Fraction(5, 6));
+    static_assert(half - third == Fraction(1, 6));
+    static_assert(half * third == Fraction(1, 6));
+    static_assert(half / third == Fraction(3, 2));
+    static_assert(third < half && half > third && half != third);
+    static_assert(Fraction(0.25f) == Fraction(1, 4));
+    static_assert(Fraction64(Fraction(3, 4)) == Fraction64(3, 4));
+    static_assert(!checked_multiply(Fraction(numeric_limits<int>::max(), 1), Fraction(2, 1)).ok());
+    static_assert(Fraction::checked_create(1, 0).error == FractionError::zero_denominator);
+    static_assert(fraction_gcd(12, 18) == 6);
+
+    TEST_CASE("constexpr results match the runtime ones") {
+        constexpr Fraction sum = Fraction(1, 6) + Fraction(1, 3);
+        constexpr Fraction128 wide = Fraction128(1, 3) * Fraction128(3, 5);
+        Fraction one_sixth(1, 6);
+        CHECK_EQ(sum, one_sixth + Fraction(1, 3));
+        CHECK_EQ(wide, Fraction128(1, 5));
+    }
+}
+
+TEST_SUITE("Three-way comparison") {
+
+    TEST_CASE("Cross products that overflow int") {
+        int max_int = numeric_limits<int>::max();
+        int min_int = numeric_limits<int>::min();
+        Fraction above_one(max_int, max_int - 1);
+        Fraction further_above_one(max_int - 1, max_int - 2);
+        CHECK(above_one < further_above_one);
+        CHECK(further_above_one > above_one);
+        CHECK(above_one <= further_above_one);
+        CHECK_FALSE(above_one >= further_above_one);
+        CHECK(Fraction(min_int, 1) < Fraction(max_int, 1));
+        CHECK(Fraction(min_int, max_int) < Fraction(-1, 1));
+        CHECK_FALSE(Fraction(1, max_int) > Fraction(1, max_int - 1));
+        CHECK(Fraction(max_int, 3) >= Fraction(max_int, 3));
+    }
+
+    TEST_CASE("Fraction64 widens to 128 bits") {
+        int64_t max_64 = numeric_limits<int64_t>::max();
+        CHECK(Fraction64(max_64, max_64 - 1) < Fraction64(max_64 - 1, max_64 - 2));
+        CHECK(Fraction64(-max_64, max_64 - 1) > Fraction64(-(max_64 - 1), max_64 - 2));
+    }
+
+    TEST_CASE("Fraction128 falls back to continued fractions") {
+        __int128 max_128 = numeric_limits<__int128>::max();
+        __int128 min_128 = numeric_limits<__int128>::min();
+        Fraction128 above_one(max_128, max_128 - 1);
+        Fraction128 further_above_one(max_128 - 1, max_128 - 2);
+        CHECK(above_one < further_above_one);
+        CHECK(further_above_one > above_one);
+        CHECK(Fraction128(min_128, max_128) < Fraction128(-1, 1));
+        CHECK(Fraction128(min_128 + 1, max_128) == Fraction128(-1, 1));
+        CHECK(Fraction128(max_128 - 1, 3) <= Fraction128(max_128 - 1, 3));
+        CHECK(Fraction128(-(max_128 - 2), max_128 - 1) > Fraction128(-(max_128 - 1), max_128));
+        CHECK(Fraction128(max_128, 7) > Fraction128(max_128 - 1, 7));
+    }
+
+    TEST_CASE("Agrees with exact BigFraction comparison") {
+        for (int num_1 = -12; num_1 <= 12; ++num_1)
+            for (int den_1 = 1; den_1 <= 12; ++den_1)
+                for (int num_2 = -12; num_2 <= 12; num_2 += 5)
+                    for (int den_2 = 1; den_2 <= 12; den_2 += 3)
+                    {
+                        __int128 scale = numeric_limits<__int128>::max() / 16;
+                        Fraction128 first = Fraction128(num_1, den_1) * Fraction128(scale, 1);
+                        Fraction128 second = Fraction128(num_2, den_2) * Fraction128(scale, 1);
+                        bool less = BigFraction(num_1, den_1) < BigFraction(num_2, den_2);
+                        CHECK_EQ(first < second, less);
+                        CHECK_EQ(first >= second, !less);
+                        CHECK_EQ(Fraction(num_1, den_1) < Fraction(num_2, den_2), less);
+                    }
+    }
+}
+
+TEST_SUITE("operator<=>") {
+
+    static_assert(three_way_comparable<Fraction, strong_ordering>);
+    static_assert(totally_ordered<Fraction128>);
+    static_assert((Fraction(1, 2) <=> Fraction(1, 3)) == strong_ordering::greater);
+    static_assert((Fraction(-2, 4) <=> Fraction(1, -2)) == strong_ordering::equal);
+
+    TEST_CASE("Mixed operands still convert") {
+        Fraction a(5, 3);
+        CHECK(a > 1.1);
+        CHECK(1.1 < a);
+        CHECK(a != 1.1);
+        CHECK(is_gt(a <=> Fraction(1, 1)));
+        CHECK(is_lt(BigFraction(1, 3) <=> BigFraction(1, 2)));
+    }
+
+    TEST_CASE("Sorting and ordered containers") {
+        vector<Fraction> values = {Fraction(3, 4), Fraction(-1, 2), Fraction(2, 3), Fraction(0, 1), Fraction(-7, 8)};
+        ranges::sort(values);
+        CHECK(ranges::is_sorted(values));
+        CHECK_EQ(values.front(), Fraction(-7, 8));
+        CHECK_EQ(values.back(), Fraction(3, 4));
+
+        // std::map probes with operator<, synthesized from the one <=> call
+        map<Fraction, int> counts;
+        for (int den = 1; den <= 6; ++den)
+            for (int num = 0; num <= den; ++num)
+                counts[Fraction(num, den)]++;
+        CHECK_EQ(counts.size(), 13);
+        CHECK_EQ(counts[Fraction(1, 2)], 3);
+        CHECK_EQ(counts.begin()->first, Fraction(0, 1));
+    }
+}
+
+TEST_SUITE("Mixed floating-point operands") {
+
+    TEST_CASE("Same results as converting the operand first") {
+        const double values[] = {0.0, 0.5, -0.25, 2.3, 2.421, -1.1, 12.963, 0.001, -0.008, 7.0, 0.125};
+        const Fraction fractions[] = {Fraction(5, 3), Fraction(-2, 7), Fraction(1, 1000), Fraction(0, 1), Fraction(125, 8)};
+        for (double value : values)
+            for (const Fraction &fraction : fractions)
+            {
+                Fraction converted(static_cast<float>(value));
+                CHECK_EQ(fraction + value, fraction + converted);
+                CHECK_EQ(value + fraction, converted + fraction);
+                CHECK_EQ(fraction - value, fraction - converted);
+                CHECK_EQ(value - fraction, converted - fraction);
+                CHECK_EQ(fraction * value, fraction * converted);
+                CHECK_EQ(value * fraction, converted * fraction);
+                if (converted != Fraction(0, 1))
+                    CHECK_EQ(fraction / value, fraction / converted);
+                if (fraction != Fraction(0, 1))
+                    CHECK_EQ(value / fraction, converted / fraction);
+                CHECK_EQ(fraction == value, fraction == converted);
+                CHECK_EQ(fraction < value, fraction < converted);
+                CHECK_EQ(value <= fraction, converted <= fraction);
+                CHECK_EQ(BigFraction(fraction.getNumerator(), fraction.getDenominator()) > value, fraction > converted);
+            }
+    }
+
+    TEST_CASE("Results are in lowest terms") {
+        Fraction product = Fraction(1, 1) * 0.4;
+        CHECK_EQ(product.getNumerator(), 2);
+        CHECK_EQ(product.getDenominator(), 5);
+        Fraction64 sum = Fraction64(1, 2) + 0.25;
+        CHECK_EQ(sum.getNumerator(), 3);
+        CHECK_EQ(sum.getDenominator(), 4);
+        CHECK_THROWS_AS(Fraction(1, 2) / 0.0, runtime_error);
+        CHECK_THROWS_AS(Fraction(numeric_limits<int>::max(), 1) * 2.0, overflow_error);
+    }
+}
+
+TEST_SUITE("Exact double conversion") {
+
+    static_assert(Fraction::from_double_exact(-2.75) == Fraction(-11, 4));
+    static_assert(Fraction::from_double_exact(0.0) == Fraction(0, 1));
+
+    TEST_CASE("Power-of-two denominators in lowest terms") {
+        CHECK_EQ(Fraction::from_double_exact(0.5), Fraction(1, 2));
+        CHECK_EQ(Fraction::from_double_exact(-0.0), Fraction(0, 1));
+        CHECK_EQ(Fraction::from_double_exact(1536.0), Fraction(1536, 1));
+        CHECK_EQ(Fraction64::from_double_exact(1e18), Fraction64(1000000000000000000, 1));
+
+        // 0.1 is not 1/10 in binary
+        Fraction64 tenth = Fraction64::from_double_exact(0.1);
+        CHECK_EQ(tenth.getNumerator(), 3602879701896397);
+        CHECK_EQ(tenth.getDenominator(), int64_t{1} << 55);
+        CHECK_NE(tenth, Fraction64(1, 10));
+    }
+
+    TEST_CASE("Round trip") {
+        mt19937_64 gen(15);
+        uniform_real_distribution<double> dist(-1e6, 1e6);
+        for (int i = 0; i < 1000; ++i)
+        {
+            double value = dist(gen);
+            Fraction128 exact = Fraction128::from_double_exact(value);
+            CHECK_EQ(static_cast<double>(exact.getNumerator()) / static_cast<double>(exact.getDenominator()), value);
+        }
+        BigFraction smallest = BigFraction::from_double_exact(5e-324);
+        CHECK_EQ(smallest.getNumerator(), BigInt(1));
+        CHECK_FALSE(smallest.getDenominator().is_small());
+        CHECK_FALSE(BigFraction::from_double_exact(-1e300).getNumerator().is_small());
+    }
+
+    TEST_CASE("Values that do not fit") {
+        CHECK_THROWS_AS(Fraction::from_double_exact(0.1), overflow_error);
+        CHECK_THROWS_AS(Fraction::from_double_exact(1e10), overflow_error);
+        CHECK_THROWS_AS(Fraction::from_double_exact(numeric_limits<double>::infinity()), invalid_argument);
+        CHECK_THROWS_AS(Fraction64::from_double_exact(numeric_limits<double>::quiet_NaN()), invalid_argument);
+    }
+}
+
+TEST_SUITE("Best rational approximation") {
+
+    static_assert(Fraction::from_double(3.141592653589793, 1000) == Fraction(355, 113));
+
+    TEST_CASE("Matches a reference limit_denominator") {
+        struct Case
+        {
+            double value;
+            int max_denominator;
+            int numerator;
+            int denominator;
+        };
+        const Case cases[] = {
+            {3.141592653589793, 1000, 355, 113},
+            {3.141592653589793, 100, 311, 99},
+            {2.718281828459045, 10000, 25946, 9545},
+            {0.1, 100, 1, 10},
+            {0.3333333333333333, 10, 1, 3},
+            {-0.333, 10, -1, 3},
+            {2.5, 1, 2, 1},
+            {1.5, 2, 3, 2},
+            {0.5, 1, 0, 1},
+            {1e-09, 1000, 0, 1},
+            {123456.789, 1000, 123456789, 1000},
+            {-7.0, 5, -7, 1},
+            {0.3183098861837907, 113, 7, 22},
+            {-27.695445017184966, 1000000, -21443226, 774251},
+            {-43.013312791358494, 100, -3226, 75},
+            {-10.648149243215357, 1000000, -8643337, 811722},
+            {70.82732566849265, 12345, 449966, 6353},
+            {-52.428266949957724, 100, -367, 7},
+            {-97.974325274531, 12345, -1118083, 11412},
+        };
+        for (const Case &test : cases)
+        {
+            CHECK_EQ(Fraction::from_double(test.value, test.max_denominator), Fraction(test.numerator, test.denominator));
+            CHECK_EQ(Fraction64::from_double(test.value, test.max_denominator), Fraction64(test.numerator, test.denominator));
+            CHECK_EQ(Fraction128::from_double(test.value, test.max_denominator), Fraction128(test.numerator, test.denominator));
+            CHECK_EQ(BigFraction::from_double(test.value, test.max_denominator), BigFraction(test.numerator, test.denominator));
+        }
+        // Ties go to the smaller denominator, and between two integers to the one closer to zero
+        CHECK_EQ(Fraction::from_double(0.75, 2), Fraction(1, 1));
+        CHECK_EQ(Fraction::from_double(-0.75, 2), Fraction(-1, 1));
+        CHECK_EQ(BigFraction::from_double(0.75, 2), BigFraction(1, 1));
+        CHECK_EQ(Fraction::from_double(2.5, 1), Fraction(2, 1));
+        CHECK_EQ(Fraction::from_double(-2.5, 1), Fraction(-2, 1));
+    }
+
+    TEST_CASE("Exact values within the bound are returned unchanged") {
+        CHECK_EQ(Fraction::from_double(0.375, 8), Fraction(3, 8));
+        CHECK_EQ(Fraction64::from_double(0.1, numeric_limits<int64_t>::max()), Fraction64::from_double_exact(0.1));
+        CHECK_EQ(Fraction::from_double(-1e6, 1), Fraction(-1000000, 1));
+    }
+
+    TEST_CASE("No fraction with a smaller denominator is closer") {
+        mt19937_64 gen(16);
+        uniform_real_distribution<double> dist(-10, 10);
+        for (int max_den = 1; max_den <= 60; ++max_den)
+        {
+            double value = dist(gen);
+            Fraction best = Fraction::from_double(value, max_den);
+            CHECK(best.getDenominator() <= max_den);
+            Fraction128 exact = Fraction128::from_double_exact(value);
+            Fraction128 best_error = Fraction128(best) - exact;
+            best_error = best_error < Fraction128(0, 1) ? Fraction128(0, 1) - best_error : best_error;
+            for (int den = 1; den <= max_den; ++den)
+            {
+                for (int num = static_cast<int>(floor(value * den)); num <= static_cast<int>(ceil(value * den)); ++num)
+                {
+                    Fraction128 error = Fraction128(num, den) - exact;
+                    error = error < Fraction128(0, 1) ? Fraction128(0, 1) - error : error;
+                    CHECK(best_error <= error);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("Errors") {
+        CHECK_THROWS_AS(Fraction::from_double(0.5, 0), invalid_argument);
+        CHECK_THROWS_AS(Fraction::from_double(numeric_limits<double>::quiet_NaN(), 10), invalid_argument);
+        CHECK_THROWS_AS(Fraction::from_double(numeric_limits<double>::infinity(), 10), invalid_argument);
+        CHECK_THROWS_AS(Fraction64::from_double(-numeric_limits<double>::infinity(), 10), invalid_argument);
+        CHECK_THROWS_AS(Fraction128::from_double(numeric_limits<double>::quiet_NaN(), 10), invalid_argument);
+        CHECK_THROWS_AS(BigFraction::from_double(numeric_limits<double>::infinity(), 10), invalid_argument);
+        CHECK_THROWS_AS(Fraction::from_double(3e9, 10), overflow_error);
+        CHECK_THROWS_AS(Fraction64::from_double(1e19, 10), overflow_error);
+        CHECK_EQ(Fraction64::from_double(1e-30, numeric_limits<int64_t>::max()), Fraction64(0, 1));
+        CHECK_EQ(Fraction128::from_double(1e30, 1).getNumerator(), Fraction128::from_double_exact(1e30).getNumerator());
+    }
+}
+
+TEST_SUITE("Conversion to floating point") {
+
+    // |value - exact| as an exact fraction
+    template <typename FloatT>
+    BigFraction distance(FloatT value, const BigFraction &exact)
+    {
+        BigFraction difference = BigFraction::from_double_exact(static_cast<double>(value)) - exact;
+        return difference < BigFraction(0, 1) ? BigFraction(0, 1) - difference : difference;
+    }
+
+    // Checks that value is the floating-point number nearest to exact
+    template <typename FloatT>
+    void check_nearest(FloatT value, const BigFraction &exact)
+    {
+        CHECK(distance(value, exact) <= distance(nextafter(value, numeric_limits<FloatT>::infinity()), exact));
+        CHECK(distance(value, exact) <= distance(nextafter(value, -numeric_limits<FloatT>::infinity()), exact));
+    }
+
+    TEST_CASE("Simple values") {
+        CHECK_EQ(Fraction(1, 2).to_double(), 0.5);
+        CHECK_EQ(Fraction(-3, 4).to_float(), -0.75f);
+        CHECK_EQ(Fraction(1, 3).to_double(), 1.0 / 3.0);
+        CHECK_EQ(Fraction64(0, 1).to_double(), 0.0);
+        CHECK_EQ(BigFraction(7, 8).to_double(), 0.875);
+    }
+
+    TEST_CASE("Ties round to even") {
+        int64_t two_53 = int64_t{1} << 53;
+        CHECK_EQ(Fraction64(two_53 + 1, 1).to_double(), 9007199254740992.0);
+        CHECK_EQ(Fraction64(two_53 + 3, 1).to_double(), 9007199254740996.0);
+        CHECK_EQ(Fraction(16777217, 1).to_float(), 16777216.0f);
+        CHECK_EQ(Fraction(16777219, 1).to_float(), 16777220.0f);
+        CHECK_EQ(Fraction(-16777219, 1).to_float(), -16777220.0f);
+    }
+
+    TEST_CASE("Correctly rounded for 32 and 64-bit terms") {
+        mt19937_64 gen(17);
+        uniform_int_distribution<int64_t> num_64(numeric_limits<int64_t>::min() + 1, numeric_limits<int64_t>::max());
+        uniform_int_distribution<int64_t> den_64(1, numeric_limits<int64_t>::max());
+        uniform_int_distribution<int> num_32(numeric_limits<int>::min() + 1, numeric_limits<int>::max());
+        uniform_int_distribution<int> den_32(1, numeric_limits<int>::max());
+        for (int i = 0; i < 300; ++i)
+        {
+            Fraction64 wide(num_64(gen), (den_64(gen) >> (i % 60)) | 1);
+            BigFraction exact(wide.getNumerator(), wide.getDenominator());
+            check_nearest(wide.to_double(), exact);
+            check_nearest(wide.to_float(), exact);
+
+            Fraction narrow(num_32(gen), (den_32(gen) >> (i % 30)) | 1);
+            BigFraction narrow_exact(narrow.getNumerator(), narrow.getDenominator());
+            check_nearest(narrow.to_double(), narrow_exact);
+            check_nearest(narrow.to_float(), narrow_exact);
+        }
+        Fraction128 huge(numeric_limits<__int128>::max(), 3);
+        check_nearest(huge.to_double(), BigFraction(huge.getNumerator(), huge.getDenominator()));
+    }
+
+    TEST_CASE("Array conversion") {
+        vector<Fraction> fractions;
+        for (int i = 1; i <= 100; ++i)
+            fractions.emplace_back(i * 7 - 300, i);
+        vector<double> doubles(fractions.size());
+        vector<float> floats(fractions.size());
+        Fraction::to_double(fractions, doubles);
+        Fraction::to_float(fractions, floats);
+        for (size_t i = 0; i < fractions.size(); ++i)
+        {
+            CHECK_EQ(doubles[i], fractions[i].to_double());
+            CHECK_EQ(floats[i], fractions[i].to_float());
+        }
+        vector<double> too_short(10);
+        CHECK_THROWS_AS(Fraction::to_double(fractions, too_short), invalid_argument);
+    }
+}
+
+TEST_SUITE("Batch arithmetic") {
+
+    template <typename FractionT>
+    vector<FractionT> random_fractions(size_t count, int max_value, unsigned seed)
+    {
+        mt19937 gen(seed);
+        uniform_int_distribution<int> num(-max_value, max_value);
+        uniform_int_distribution<int> den(1, max_value);
+        vector<FractionT> result;
+        for (size_t i = 0; i < count; ++i)
+            result.emplace_back(num(gen), den(gen));
+        return result;
+    }
+
+    TEST_CASE_TEMPLATE("Element-wise results match the operators", FractionT, Fraction, Fraction64, Fraction128, BigFraction) {
+        vector<FractionT> lhs = random_fractions<FractionT>(500, 1000, 18);
+        vector<FractionT> rhs = random_fractions<FractionT>(500, 1000, 19);
+        for (FractionT &value : rhs)
+            if (value == FractionT(0, 1))
+                value = FractionT(1, 7);
+        vector<FractionT> out(lhs.size());
+        FractionT::batch_add(lhs, rhs, out);
+        for (size_t i = 0; i < lhs.size(); ++i)
+            CHECK_EQ(out[i], lhs[i] + rhs[i]);
+        FractionT::batch_subtract(lhs, rhs, out);
+        for (size_t i = 0; i < lhs.size(); ++i)
+            CHECK_EQ(out[i], lhs[i] - rhs[i]);
+        FractionT::batch_multiply(lhs, rhs, out);
+        for (size_t i = 0; i < lhs.size(); ++i)
+            CHECK_EQ(out[i], lhs[i] * rhs[i]);
+        FractionT::batch_divide(lhs, rhs, out);
+        for (size_t i = 0; i < lhs.size(); ++i)
+            CHECK_EQ(out[i], lhs[i] / rhs[i]);
+
+        vector<int> order(lhs.size());
+        FractionT::batch_compare(lhs, rhs, order);
+        for (size_t i = 0; i < lhs.size(); ++i)
+            CHECK_EQ(order[i], lhs[i] < rhs[i] ? -1 : (lhs[i] == rhs[i] ? 0 : 1));
+    }
+
+    TEST_CASE("Scalar right-hand side and in-place updates") {
+        vector<Fraction> values = random_fractions<Fraction>(200, 100, 20);
+        vector<Fraction> original = values;
+        Fraction::batch_multiply(values, Fraction(-3, 7), values);
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK_EQ(values[i], original[i] * Fraction(-3, 7));
+        // The scalar may be an element of the output
+        Fraction::batch_subtract(values, values[0], values);
+        CHECK_EQ(values[0], Fraction(0, 1));
+        CHECK_EQ(values[1], original[1] * Fraction(-3, 7) - original[0] * Fraction(-3, 7));
+
+        vector<int> order(values.size());
+        Fraction::batch_compare(original, Fraction(0, 1), order);
+        for (size_t i = 0; i < original.size(); ++i)
+            CHECK_EQ(order[i], original[i] < Fraction(0, 1) ? -1 : (original[i] == Fraction(0, 1) ? 0 : 1));
+    }
+
+    TEST_CASE("Errors") {
+        int max_int = numeric_limits<int>::max();
+        vector<Fraction> lhs = {Fraction(1, 2), Fraction(max_int, 1)};
+        vector<Fraction> rhs = {Fraction(1, 3), Fraction(max_int, 1)};
+        vector<Fraction> out(2);
+        CHECK_THROWS_AS(Fraction::batch_add(lhs, rhs, out), overflow_error);
+        CHECK_THROWS_AS(Fraction::batch_divide(lhs, Fraction(0, 1), out), runtime_error);
+        vector<Fraction64> wide = {Fraction64(1, 2)};
+        CHECK_THROWS_AS(Fraction64::batch_divide(wide, Fraction64(0, 1), wide), runtime_error);
+        vector<Fraction> short_out(1);
+        CHECK_THROWS_AS(Fraction::batch_multiply(lhs, rhs, short_out), invalid_argument);
+        CHECK_THROWS_AS(Fraction::batch_multiply(lhs, vector<Fraction>(3), out), invalid_argument);
+
+        // The first failing element stops the batch: nothing truncated is stored, and a later
+        // zero divisor does not hide the overflow
+        vector<Fraction> dividends = {Fraction(1, 2), Fraction(max_int, 1), Fraction(1, 3)};
+        vector<Fraction> divisors = {Fraction(1, 4), Fraction(1, 2), Fraction(0, 1)};
+        vector<Fraction> quotients(3, Fraction(5, 7));
+        CHECK_THROWS_AS(Fraction::batch_divide(dividends, divisors, quotients), overflow_error);
+        CHECK_EQ(quotients[0], Fraction(2, 1));
+        CHECK_EQ(quotients[1], Fraction(5, 7));
+        CHECK_EQ(quotients[2], Fraction(5, 7));
+        vector<Fraction> sums(2, Fraction(5, 7));
+        CHECK_THROWS_AS(Fraction::batch_add(lhs, rhs, sums), overflow_error);
+        CHECK_EQ(sums[0], Fraction(5, 6));
+        CHECK_EQ(sums[1], Fraction(5, 7));
+
+        // Only the reduced result has to fit
+        vector<Fraction> halves = {Fraction(max_int - 1, 2)};
+        Fraction::batch_add(halves, halves, out);
+        CHECK_EQ(out[0], Fraction(max_int - 1, 1));
+    }
+}
+
+TEST_SUITE("FractionColumn") {
+
+    TEST_CASE("Stores normalized terms in separate aligned arrays") {
+        FractionColumn column;
+        column.push_back(Fraction(2, 4));
+        column.push_back(Fraction(-3, 9));
+        column.push_back(Fraction(5, 1));
+        CHECK_EQ(column.size(), 3);
+        CHECK_EQ(column[1], Fraction(-1, 3));
+        CHECK_EQ(column.numerators()[0], 1);
+        CHECK_EQ(column.denominators()[0], 2);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(column.numerators().data()) % 64, 0);
+        CHECK_EQ(reinterpret_cast<uintptr_t>(column.denominators().data()) % 64, 0);
+
+        column.set(2, Fraction(7, 2));
+        CHECK_EQ(column[2], Fraction(7, 2));
+        column.resize(4);
+        CHECK_EQ(column[3], Fraction(0, 1));
+    }
+
+    TEST_CASE("Iterators yield Fraction values") {
+        static_assert(random_access_iterator<FractionColumn::const_iterator>);
+        vector<Fraction> fractions = {Fraction(1, 2), Fraction(1, 3), Fraction(1, 4)};
+        FractionColumn column(fractions);
+        vector<Fraction> copied(column.begin(), column.end());
+        CHECK_EQ(copied, fractions);
+        CHECK_EQ(column.end() - column.begin(), 3);
+        CHECK_EQ(*(column.begin() + 2), Fraction(1, 4));
+        CHECK_EQ(ranges::max(column), Fraction(1, 2));
+        Fraction sum;
+        for (Fraction fraction : column)
+            sum = sum + fraction;
+        CHECK_EQ(sum, Fraction(13, 12));
+    }
+
+    TEST_CASE("Common denominators") {
+        FractionColumn column;
+        CHECK(column.has_common_denominator());
+        for (int num = 1; num < 100; num += 2)
+            column.push_back(Fraction(num, 16));
+        CHECK(column.has_common_denominator());
+        column.push_back(Fraction(1, 8));
+        CHECK_FALSE(column.has_common_denominator());
+    }
+
+    TEST_CASE("Batch operations match the vector ones") {
+        mt19937 gen(19);
+        uniform_int_distribution<int> num(-500, 500);
+        uniform_int_distribution<int> den(1, 500);
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (int i = 0; i < 300; ++i)
+        {
+            lhs.emplace_back(num(gen), den(gen));
+            rhs.emplace_back(num(gen) | 1, den(gen));
+        }
+        FractionColumn left(lhs);
+        FractionColumn right(rhs);
+        FractionColumn result;
+        vector<Fraction> expected(lhs.size());
+
+        FractionColumn::batch_add(left, right, result);
+        Fraction::batch_add(lhs, rhs, expected);
+        CHECK(ranges::equal(result, expected));
+        FractionColumn::batch_subtract(left, right, result);
+        Fraction::batch_subtract(lhs, rhs, expected);
+        CHECK(ranges::equal(result, expected));
+        FractionColumn::batch_multiply(left, Fraction(-2, 3), result);
+        Fraction::batch_multiply(lhs, Fraction(-2, 3), expected);
+        CHECK(ranges::equal(result, expected));
+        FractionColumn::batch_divide(left, right, left);
+        Fraction::batch_divide(lhs, rhs, expected);
+        CHECK(ranges::equal(left, expected));
+
+        vector<int> order(rhs.size());
+        vector<int> expected_order(rhs.size());
+        FractionColumn::batch_compare(right, FractionColumn(expected), order);
+        Fraction::batch_compare(rhs, expected, expected_order);
+        CHECK_EQ(order, expected_order);
+
+        vector<double> doubles(rhs.size());
+        right.to_double(doubles);
+        CHECK_EQ(doubles[7], rhs[7].to_double());
+
+        CHECK_THROWS_AS(FractionColumn::batch_add(left, FractionColumn(3), result), invalid_argument);
+        CHECK_THROWS_AS(FractionColumn::batch_divide(left, Fraction(0, 1), result), runtime_error);
+        FractionColumn64 wide(vector<Fraction64>{Fraction64(1, 3)});
+        FractionColumn64::batch_add(wide, wide, wide);
+        CHECK_EQ(wide[0], Fraction64(2, 3));
+    }
+}
+
+TEST_SUITE("SIMD kernels") {
+
+    TEST_CASE("Every level matches the scalar kernels") {
+        mt19937 gen(20);
+        uniform_int_distribution<int> num(numeric_limits<int>::min(), numeric_limits<int>::max());
+        uniform_int_distribution<int> den(1, numeric_limits<int>::max());
+        // An odd count leaves a tail for the scalar loop at every vector width
+        const size_t count = 1003;
+        vector<int> num_1(count), den_1(count), num_2(count), den_2(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            num_1[i] = num(gen);
+            den_1[i] = den(gen);
+            num_2[i] = num(gen);
+            den_2[i] = den(gen);
+        }
+        // Equal fractions and extreme terms
+        num_2[0] = num_1[0];
+        den_2[0] = den_1[0];
+        num_1[1] = 2;
+        den_1[1] = 4;
+        num_2[1] = 1;
+        den_2[1] = 2;
+        num_1[2] = numeric_limits<int>::min();
+        den_1[2] = 1;
+        num_2[2] = numeric_limits<int>::max();
+        den_2[2] = numeric_limits<int>::max();
+
+        vector<int> expected_order(count);
+        vector<int64_t> expected_num(count), expected_den(count);
+        compare_terms(num_1.data(), den_1.data(), num_2.data(), den_2.data(), expected_order.data(), count, SimdLevel::scalar);
+        multiply_terms(num_1.data(), den_1.data(), num_2.data(), den_2.data(), expected_num.data(), expected_den.data(), count, SimdLevel::scalar);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const strong_ordering order = Fraction64(num_1[i], den_1[i]) <=> Fraction64(num_2[i], den_2[i]);
+            CHECK_EQ(expected_order[i], order < 0 ? -1 : (order == 0 ? 0 : 1));
+            CHECK_EQ(expected_num[i], int64_t{num_1[i]} * num_2[i]);
+        }
+
+        for (SimdLevel level : {SimdLevel::sse41, SimdLevel::avx2})
+        {
+            vector<int> order(count);
+            vector<int64_t> num_out(count), den_out(count);
+            compare_terms(num_1.data(), den_1.data(), num_2.data(), den_2.data(), order.data(), count, level);
+            CHECK_EQ(order, expected_order);
+            multiply_terms(num_1.data(), den_1.data(), num_2.data(), den_2.data(), num_out.data(), den_out.data(), count, level);
+            CHECK_EQ(num_out, expected_num);
+            CHECK_EQ(den_out, expected_den);
+
+            vector<int64_t> scaled_num(count), scaled_den(count);
+            scale_terms(num_1.data(), den_1.data(), -7, numeric_limits<int>::max(), num_out.data(), den_out.data(), count, level);
+            scale_terms(num_1.data(), den_1.data(), -7, numeric_limits<int>::max(), scaled_num.data(), scaled_den.data(), count, SimdLevel::scalar);
+            CHECK_EQ(num_out, scaled_num);
+            CHECK_EQ(den_out, scaled_den);
+        }
+    }
+
+    TEST_CASE("Short arrays only take the scalar tail") {
+        const int num_1[] = {1, -1, 3};
+        const int den_1[] = {2, 2, 4};
+        const int num_2[] = {1, 1, 6};
+        const int den_2[] = {3, 3, 8};
+        for (size_t count = 0; count <= 3; ++count)
+        {
+            int order[3] = {9, 9, 9};
+            compare_terms(num_1, den_1, num_2, den_2, order, count, simd_level());
+            for (size_t i = 0; i < 3; ++i)
+                CHECK_EQ(order[i], i < count ? vector<int>{1, -1, 0}[i] : 9);
+        }
+    }
+
+    TEST_CASE("Batch reduce matches fraction_gcd at every level") {
+        mt19937_64 gen(21);
+        uniform_int_distribution<int> term(numeric_limits<int>::min() + 1, numeric_limits<int>::max());
+        uniform_int_distribution<int> small(-64, 64);
+        const size_t count = 1001;
+        vector<int64_t> num(count), den(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            // Products of ints, some with large common powers of two and some sharing small factors
+            num[i] = int64_t{term(gen)} * (i % 3 == 0 ? small(gen) : term(gen));
+            den[i] = int64_t{term(gen)} * (i % 3 == 0 ? small(gen) | 1 : term(gen));
+            if (i % 5 == 0)
+            {
+                num[i] = (num[i] >> 20) << 20;
+                den[i] = ((den[i] >> 24) << 24) | (int64_t{1} << 24);
+            }
+        }
+        num[0] = 0;
+        den[0] = -12;
+        num[1] = numeric_limits<int64_t>::max();
+        den[1] = numeric_limits<int64_t>::max();
+        num[2] = -(int64_t{1} << 62);
+        den[2] = int64_t{3} << 60;
+
+        vector<int64_t> expected_num = num, expected_den = den;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const int64_t common = fraction_gcd(expected_num[i], expected_den[i]) * (expected_den[i] < 0 ? -1 : 1);
+            expected_num[i] /= common;
+            expected_den[i] /= common;
+        }
+        CHECK_EQ(expected_num[0], 0);
+        CHECK_EQ(expected_den[0], 1);
+        CHECK_EQ(expected_num[2], -4);
+        CHECK_EQ(expected_den[2], 3);
+
+        for (SimdLevel level : {SimdLevel::scalar, SimdLevel::sse41, SimdLevel::avx2})
+        {
+            vector<int64_t> reduced_num = num, reduced_den = den;
+            reduce_terms(reduced_num.data(), reduced_den.data(), count, level);
+            CHECK_EQ(reduced_num, expected_num);
+            CHECK_EQ(reduced_den, expected_den);
+        }
+    }
+
+    TEST_CASE("Batch reduce of terms that fit in 32 bits") {
+        // Whole blocks of small terms take the eight-lane path; one large term moves its block to 64-bit lanes
+        mt19937 gen(22);
+        uniform_int_distribution<int> term(-1 << 15, 1 << 15);
+        const size_t count = 515;
+        vector<int64_t> num(count), den(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            num[i] = int64_t{term(gen)} * term(gen);
+            den[i] = (int64_t{term(gen)} * term(gen)) | 2;
+        }
+        num[3] = numeric_limits<int>::max();
+        den[3] = int64_t{numeric_limits<int>::max()} * 3;
+        num[20] = int64_t{1} << 31;
+        den[20] = int64_t{3} << 30;
+
+        for (SimdLevel level : {SimdLevel::sse41, SimdLevel::avx2})
+        {
+            vector<int64_t> reduced_num = num, reduced_den = den;
+            vector<int64_t> expected_num = num, expected_den = den;
+            reduce_terms(reduced_num.data(), reduced_den.data(), count, level);
+            reduce_terms(expected_num.data(), expected_den.data(), count, SimdLevel::scalar);
+            CHECK_EQ(reduced_num, expected_num);
+            CHECK_EQ(reduced_den, expected_den);
+            CHECK_EQ(reduced_num[3], 1);
+            CHECK_EQ(reduced_den[3], 3);
+            CHECK_EQ(reduced_num[20], 2);
+            CHECK_EQ(reduced_den[20], 3);
+        }
+    }
+
+    TEST_CASE("FractionColumn normalizes unreduced terms in one pass") {
+        vector<Fraction> lhs;
+        vector<Fraction> rhs;
+        for (int i = 1; i <= 50; ++i)
+        {
+            lhs.emplace_back(i * 7 - 100, i + 3);
+            rhs.emplace_back(i * 12, 2 * i - 101);
+        }
+        const FractionColumn left(lhs);
+        const FractionColumn right(rhs);
+        vector<int64_t> num(lhs.size()), den(lhs.size());
+        multiply_terms(left.numerators().data(), left.denominators().data(), right.numerators().data(), right.denominators().data(),
+                       num.data(), den.data(), lhs.size());
+        FractionColumn product;
+        product.assign_unreduced(num, den);
+        vector<Fraction> expected(lhs.size());
+        Fraction::batch_multiply(lhs, rhs, expected);
+        CHECK(ranges::equal(product, expected));
+
+        vector<int64_t> zero_num = {1, 2}, zero_den = {3, 0};
+        CHECK_THROWS_AS(product.assign_unreduced(zero_num, zero_den), invalid_argument);
+        vector<int64_t> wide_num = {int64_t{1} << 40}, wide_den = {3};
+        CHECK_THROWS_AS(product.assign_unreduced(wide_num, wide_den), overflow_error);
+        CHECK_EQ(product.size(), lhs.size());
+        wide_den[0] = int64_t{1} << 20;
+        product.assign_unreduced(wide_num, wide_den);
+        CHECK_EQ(product.size(), 1);
+        CHECK_EQ(product[0], Fraction(1 << 20, 1));
+
+        FractionColumn64 wide;
+        vector<int64_t> wide_64_num = {int64_t{6} << 40}, wide_64_den = {-4};
+        wide.assign_unreduced(wide_64_num, wide_64_den);
+        CHECK_EQ(wide[0], Fraction64(-(int64_t{3} << 40), 2));
+    }
+}
+
+TEST_SUITE("Lazy normalization") {
+
+    TEST_CASE("Arithmetic defers reduce until the value is observed") {
+        LazyFraction a(5, 3), b(14, 21);
+        CHECK_FALSE(b.is_reduced());
+        LazyFraction c = a + b - 1;
+        CHECK_FALSE(c.is_reduced());
+        CHECK_EQ(c.value(), Fraction(5, 3) + Fraction(14, 21) - 1);
+        CHECK(c.is_reduced());
+        CHECK_EQ(c.getNumerator(), 4);
+        CHECK_EQ(c.getDenominator(), 3);
+
+        LazyFraction d = c++;
+        CHECK_EQ(d, LazyFraction(4, 3));
+        CHECK_EQ(--c, LazyFraction(8, 6));
+        CHECK(c.is_reduced());
+        CHECK(c >= b);
+        CHECK(a > 1.1);
+        CHECK_EQ(a * b / LazyFraction(-10, 9), LazyFraction(-1, 1));
+        CHECK_EQ(LazyFraction(3, -6).value(), Fraction(-1, 2));
+        CHECK_EQ(LazyFraction(numeric_limits<int>::min(), -2), LazyFraction(1073741824, 1));
+        CHECK_EQ(LazyFraction(6, numeric_limits<int>::min()).value(), Fraction(6, numeric_limits<int>::min()));
+        CHECK_THROWS_AS(LazyFraction(numeric_limits<int>::min(), -1), overflow_error);
+        CHECK_EQ(LazyFraction(0, 7).getDenominator(), 1);
+
+        ostringstream output;
+        output << LazyFraction(6, 8);
+        CHECK_EQ(output.str(), "3/4");
+        istringstream input("10 4");
+        LazyFraction read;
+        input >> read;
+        CHECK_EQ(read, LazyFraction(5, 2));
+        CHECK_EQ(LazyFraction(9, 12).to_double(), 0.75);
+    }
+
+    TEST_CASE("Long chains agree with the eager type") {
+        mt19937 gen(22);
+        // Small enough for the eager type; the lazy terms overflow often and take the reducing fallback
+        uniform_int_distribution<int> num(-9, 9);
+        uniform_int_distribution<int> den(1, 12);
+        for (int round = 0; round < 200; ++round)
+        {
+            Fraction eager(1, 2);
+            LazyFraction lazy(1, 2);
+            for (int step = 0; step < 12; ++step)
+            {
+                const int numerator = num(gen) | 1;
+                const int denominator = den(gen);
+                switch (step % 4)
+                {
+                case 0:
+                    eager = eager + Fraction(numerator, denominator);
+                    lazy = lazy + LazyFraction(numerator, denominator);
+                    break;
+                case 1:
+                    eager = eager * Fraction(numerator, denominator);
+                    lazy = lazy * LazyFraction(numerator, denominator);
+                    break;
+                case 2:
+                    eager = eager - Fraction(numerator, denominator);
+                    lazy = lazy - LazyFraction(numerator, denominator);
+                    break;
+                default:
+                    eager = eager / Fraction(numerator, denominator);
+                    lazy = lazy / LazyFraction(numerator, denominator);
+                }
+            }
+            CHECK_EQ(lazy.value(), eager);
+        }
+    }
+
+    TEST_CASE("Terms at risk of overflow are reduced first") {
+        const int max_int = numeric_limits<int>::max();
+        // The unreduced product 2^30 * 3 / (3 * 2^30) overflows, its reduced value does not
+        LazyFraction big(1 << 30, 3);
+        LazyFraction product = big * LazyFraction(3 * 3, 3 << 29);
+        CHECK_EQ(product, LazyFraction(2, 1));
+        CHECK(product.is_reduced());
+
+        LazyFraction sum = LazyFraction(max_int - 1, 4) + LazyFraction(6, 4);
+        CHECK_EQ(sum.value(), Fraction(536870913, 1));
+        LazyFraction near_max(max_int - 1, 1);
+        CHECK_EQ(++near_max, LazyFraction(max_int, 1));
+        CHECK_THROWS_AS(++near_max, overflow_error);
+        CHECK_THROWS_AS(LazyFraction(max_int, 2) * LazyFraction(3, 1), overflow_error);
+        CHECK_THROWS_AS(LazyFraction(1, 2) / LazyFraction(0, 5), runtime_error);
+        CHECK_THROWS_AS(LazyFraction(1, 0), invalid_argument);
+        CHECK_THROWS_AS(LazyFraction(1, numeric_limits<int>::min()), overflow_error);
+    }
+
+    TEST_CASE("Equal values hash equally") {
+        unordered_set<LazyFraction> seen;
+        seen.insert(LazyFraction(1, 2));
+        seen.insert(LazyFraction(2, 4));
+        seen.insert(LazyFraction(1, 3) + LazyFraction(1, 6));
+        seen.insert(Fraction(5, 10));
+        CHECK_EQ(seen.size(), 1);
+        CHECK(seen.contains(LazyFraction(-3, -6)));
+        CHECK_EQ(hash<LazyFraction64>()(LazyFraction64(4, 6)), hash<LazyFraction64>()(LazyFraction64(2, 3)));
+    }
+}
+
+TEST_SUITE("Fused expressions") {
+
+    TEST_CASE("Expressions evaluate like the eager operators") {
+        Fraction a(5, 3), b(14, 21);
+        Fraction c = fuse(a) + b - 1;
+        CHECK_EQ(c, a + b - 1);
+        CHECK_EQ(fuse(a) * b / Fraction(-10, 9), Fraction(-1, 1));
+        CHECK_EQ(2.3 * fuse(b), 2.3 * b);
+        CHECK_EQ(fuse(a) + 2.421, a + 2.421);
+        CHECK_EQ((fuse(a) - b) * (fuse(a) + b), a * a - b * b);
+        CHECK_EQ(b - fuse(a) / 4, b - a / 4);
+        CHECK_EQ((fuse(a) + b).evaluate(), Fraction(7, 3));
+        CHECK(fuse(a) + b > a);
+        CHECK_EQ(fuse(Fraction64(1, 3)) + Fraction64(1, 6), Fraction64(1, 2));
+        CHECK_EQ(fuse(BigFraction(1, 3)) * BigFraction(3, 5), BigFraction(1, 5));
+        static_assert(FractionExpression<decltype(fuse(a) + b + b)>);
+        static_assert(!FractionExpression<Fraction>);
+        static_assert(is_same_v<decltype(a + b), Fraction>);
+    }
+
+    TEST_CASE("Sums and products of many terms") {
+        mt19937 gen(23);
+        // lcm(1..12) keeps every eager partial sum within int
+        uniform_int_distribution<int> num(-50, 50);
+        uniform_int_distribution<int> den(1, 12);
+        for (int round = 0; round < 300; ++round)
+        {
+            vector<Fraction> terms;
+            for (int i = 0; i < 10; ++i)
+                terms.emplace_back(num(gen) | 1, den(gen));
+            const Fraction sum = fuse(terms[0]) + terms[1] - terms[2] + terms[3] + terms[4] - terms[5] + terms[6] + terms[7] - terms[8] + terms[9];
+            const Fraction expected_sum = terms[0] + terms[1] - terms[2] + terms[3] + terms[4] - terms[5] + terms[6] + terms[7] - terms[8] + terms[9];
+            CHECK_EQ(sum, expected_sum);
+            const Fraction mixed = fuse(terms[0]) * terms[1] / terms[2] + terms[3] * terms[4] - terms[5] / terms[6];
+            CHECK_EQ(mixed, terms[0] * terms[1] / terms[2] + terms[3] * terms[4] - terms[5] / terms[6]);
+        }
+    }
+
+    TEST_CASE("Only the reduced result has to fit") {
+        const int max_int = numeric_limits<int>::max();
+        // The eager a * b throws, the fused expression cancels before narrowing
+        CHECK_THROWS_AS(Fraction(max_int, 1) * Fraction(2, 1) / Fraction(4, 1), overflow_error);
+        CHECK_EQ(fuse(Fraction(max_int, 1)) * Fraction(2, 1) / Fraction(4, 1), Fraction(max_int, 2));
+        CHECK_THROWS_AS(Fraction(fuse(Fraction(max_int, 1)) + Fraction(1, 1)), overflow_error);
+        CHECK_THROWS_AS(Fraction(fuse(Fraction(1, 2)) / Fraction(0, 1)), runtime_error);
+
+        // Denominators whose product overflows the accumulator fall back to cross-cancelling
+        Fraction64 sum = fuse(Fraction64(1, int64_t{1} << 40)) + Fraction64(1, int64_t{3} << 40) + Fraction64(1, int64_t{5} << 40) +
+                         Fraction64(1, int64_t{7} << 40);
+        CHECK_EQ(sum, Fraction64(1, int64_t{1} << 40) + Fraction64(1, int64_t{3} << 40) + Fraction64(1, int64_t{5} << 40) +
+                          Fraction64(1, int64_t{7} << 40));
+    }
+}
+
+TEST_SUITE("Fused multiply-add") {
+
+    TEST_CASE_TEMPLATE("fma matches a * b + c", FractionT, Fraction, Fraction64, Fraction128, BigFraction) {
+        mt19937 gen(24);
+        uniform_int_distribution<int> num(-1000, 1000);
+        uniform_int_distribution<int> den(1, 1000);
+        for (int round = 0; round < 500; ++round)
+        {
+            const FractionT a(num(gen), den(gen)), b(num(gen), den(gen)), c(num(gen), den(gen));
+            CHECK_EQ(fma(a, b, c), a * b + c);
+        }
+        CHECK_EQ(fma(FractionT(0, 1), FractionT(3, 7), FractionT(-2, 4)), FractionT(-1, 2));
+        CHECK_EQ(fma(FractionT(2, 3), FractionT(3, 2), FractionT(-1, 1)), FractionT(0, 1));
+    }
+
+    TEST_CASE("fma reduces once and only the result has to fit") {
+        const int max_int = numeric_limits<int>::max();
+        // a * b overflows on its own, a * b + c does not
+        CHECK_THROWS_AS(Fraction(max_int, 1) * Fraction(2, 1) + Fraction(-max_int, 1), overflow_error);
+        CHECK_EQ(fma(Fraction(max_int, 1), Fraction(2, 1), Fraction(-max_int, 1)), Fraction(max_int, 1));
+        CHECK_THROWS_AS(fma(Fraction(max_int, 1), Fraction(1, 1), Fraction(1, 1)), overflow_error);
+
+        // Fraction64 terms overflow the unreduced form and take the operators' cross-cancelling path
+        const int64_t big = int64_t{1} << 40;
+        CHECK_EQ(fma(Fraction64(big, 3), Fraction64(3, big), Fraction64(1, big)), Fraction64(big + 1, big));
+        CHECK_THROWS_AS(fma(Fraction64(numeric_limits<int64_t>::max(), 1), Fraction64(2, 1), Fraction64(1, 1)), overflow_error);
+
+        // std::fma is still found for doubles
+        CHECK_EQ(fma(2.0, 3.0, 1.0), 7.0);
+    }
+
+    TEST_CASE("Compound += and *= update in place") {
+        Fraction sum;
+        for (int den = 1; den <= 6; ++den)
+            sum += Fraction(1, den);
+        CHECK_EQ(sum, Fraction(49, 20));
+        Fraction product(1, 1);
+        for (int num = 1; num <= 6; ++num)
+            product *= Fraction(num, num + 1);
+        CHECK_EQ(product, Fraction(1, 7));
+
+        Fraction self(3, 4);
+        self += self;
+        CHECK_EQ(self, Fraction(3, 2));
+        self *= self;
+        CHECK_EQ(self, Fraction(9, 4));
+        Fraction &reference = (self += Fraction(1, 4));
+        CHECK_EQ(&reference, &self);
+
+        Fraction big(numeric_limits<int>::max(), 1);
+        CHECK_THROWS_AS(big += Fraction(1, 1), overflow_error);
+        CHECK_THROWS_AS(big *= Fraction(2, 1), overflow_error);
+        CHECK_EQ(big, Fraction(numeric_limits<int>::max(), 1));
+
+        BigFraction exact(1, 3);
+        exact *= BigFraction(3, 2);
+        exact += BigFraction(2, 3);
+        CHECK_EQ(exact, BigFraction(7, 6));
+    }
+}
+
+TEST_SUITE("Compound assignment") {
+
+    TEST_CASE_TEMPLATE("Compound operators match the binary operators", FractionT, Fraction, Fraction64, Fraction128, BigFraction) {
+        mt19937 gen(25);
+        uniform_int_distribution<int> num(-1000, 1000);
+        uniform_int_distribution<int> den(1, 1000);
+        for (int round = 0; round < 500; ++round)
+        {
+            const FractionT a(num(gen), den(gen)), b(num(gen), den(gen));
+            FractionT sum = a, difference = a, product = a, quotient = a;
+            sum += b;
+            difference -= b;
+            product *= b;
+            CHECK_EQ(sum, a + b);
+            CHECK_EQ(difference, a - b);
+            CHECK_EQ(product, a * b);
+            if (b != FractionT(0, 1))
+            {
+                quotient /= b;
+                CHECK_EQ(quotient, a / b);
+            }
+        }
+    }
+
+    TEST_CASE("Compound operators with doubles and chaining") {
+        Fraction a(1, 2);
+        a += 0.25;
+        CHECK_EQ(a, Fraction(3, 4));
+        a -= 1.0;
+        CHECK_EQ(a, Fraction(-1, 4));
+        a *= 2.0;
+        CHECK_EQ(a, Fraction(-1, 2));
+        a /= 0.5;
+        CHECK_EQ(a, Fraction(-1, 1));
+        (a += Fraction(1, 3)) *= Fraction(3, 1);
+        CHECK_EQ(a, Fraction(-2, 1));
+        CHECK_EQ(&(a -= Fraction(1, 1)), &a);
+    }
+
+    TEST_CASE("An object can be both operands") {
+        Fraction a(2, 3);
+        a += a;
+        CHECK_EQ(a, Fraction(4, 3));
+        a *= a;
+        CHECK_EQ(a, Fraction(16, 9));
+        a /= a;
+        CHECK_EQ(a, Fraction(1, 1));
+        a -= a;
+        CHECK_EQ(a, Fraction(0, 1));
+
+        BigFraction big(BigInt(__int128{1} << 100), BigInt(3));
+        big *= big;
+        CHECK_EQ(big, BigFraction(BigInt(__int128{1} << 100) * BigInt(__int128{1} << 100), BigInt(9)));
+        big += big;
+        CHECK_EQ(big, BigFraction(BigInt(__int128{1} << 100) * BigInt(__int128{1} << 101), BigInt(9)));
+        big /= big;
+        CHECK_EQ(big, BigFraction(1, 1));
+        big -= big;
+        CHECK_EQ(big, BigFraction(0, 1));
+    }
+
+    TEST_CASE("BigFraction compound operators on heap terms match the binary operators") {
+        mt19937 gen(24);
+        uniform_int_distribution<int> num(-1000, 1000);
+        uniform_int_distribution<int> den(1, 1000);
+        const BigInt offset(__int128{1} << 100);
+        for (int round = 0; round < 500; ++round)
+        {
+            const BigFraction a(offset * BigInt(num(gen)) + BigInt(num(gen)), BigInt(den(gen)));
+            const BigFraction b(BigInt(num(gen)), offset + BigInt(den(gen)));
+            for (const auto &[left, right] : {pair{a, b}, pair{b, a}, pair{a, BigFraction(0, 1) - a}})
+            {
+                BigFraction sum = left, difference = left, product = left, quotient = left;
+                sum += right;
+                difference -= right;
+                product *= right;
+                CHECK_EQ(sum, left + right);
+                CHECK_EQ(difference, left - right);
+                CHECK_EQ(product, left * right);
+                if (right != BigFraction(0, 1))
+                {
+                    quotient /= right;
+                    CHECK_EQ(quotient, left / right);
+                }
+            }
+        }
+        BigFraction zero(0, 1);
+        CHECK_THROWS_AS(zero /= BigFraction(0, 1), runtime_error);
+    }
+
+    TEST_CASE("Failed compound operators leave the object unchanged") {
+        const int max_int = numeric_limits<int>::max();
+        Fraction a(max_int, 1);
+        CHECK_THROWS_AS(a += Fraction(1, 1), overflow_error);
+        CHECK_EQ(a, Fraction(max_int, 1));
+        CHECK_THROWS_AS(a *= Fraction(2, 1), overflow_error);
+        CHECK_EQ(a, Fraction(max_int, 1));
+        CHECK_THROWS_AS(a /= Fraction(0, 1), runtime_error);
+        CHECK_EQ(a, Fraction(max_int, 1));
+        Fraction b(-max_int, 1);
+        CHECK_THROWS_AS(b -= Fraction(2, 1), overflow_error);
+        CHECK_EQ(b, Fraction(-max_int, 1));
+    }
+
+    TEST_CASE("By-value results can be moved from") {
+        const Fraction a(1, 2), b(1, 3);
+        static_assert(is_same_v<decltype(a + b), Fraction>);
+        static_assert(is_same_v<decltype(a * 2.0), Fraction>);
+        static_assert(is_same_v<decltype(a - b), Fraction>);
+        static_assert(is_nothrow_move_constructible_v<BigFraction>);
+        static_assert(is_nothrow_move_assignable_v<BigFraction>);
+
+        Fraction c(1, 2);
+        static_assert(is_same_v<decltype(++c), Fraction &>);
+        static_assert(is_same_v<decltype(c++), Fraction>);
+        CHECK_EQ(&++c, &c);
+        CHECK_EQ(&--c, &c);
+        ++++c;
+        CHECK_EQ(c, Fraction(5, 2));
+
+        // A moved BigFraction takes the other's terms; the moved-from object stays assignable
+        BigFraction source(BigInt(__int128{1} << 100) + BigInt(1), BigInt(7));
+        const BigFraction copy = source;
+        BigFraction target = move(source);
+        CHECK_EQ(target, copy);
+        source = BigFraction(1, 2);
+        CHECK_EQ(source, BigFraction(1, 2));
+        target = move(source);
+        CHECK_EQ(target, BigFraction(1, 2));
+
+        LazyFraction lazy(1, 2);
+        static_assert(is_same_v<decltype(++lazy), LazyFraction &>);
+        static_assert(is_same_v<decltype(lazy + lazy), LazyFraction>);
+        CHECK_EQ(&++lazy, &lazy);
+        CHECK_EQ(lazy.value(), Fraction(3, 2));
+    }
+}
@@ -0,0 +1,14 @@
+#include "Fraction.hpp"
+
+// The BigInt instantiation of Fraction.hpp, kept apart from the fixed-width ones in Fraction.cpp.
+// In a translation unit of its own the optimizer's per-unit inlining budget is left to BigInt's inline
+// fast paths, so arithmetic on inline values compiles to the same straight-line code as the built-in types.
+// Header-only builds (-DFRACTION_HEADER_ONLY) do not need to link it.
+
+using namespace std;
+
+namespace ariel
+{
+    template class BasicFraction<BigInt>;
+
+};
@@ -0,0 +1,591 @@
+#include "BigInt.hpp"
+#include "Gcd.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        using uint128 = unsigned __int128;
+
+        // Largest power of ten that fits in one limb, used for decimal conversion
+        const uint64_t DECIMAL_BASE = 10000000000000000000ULL;
+        const int DECIMAL_DIGITS = 19;
+
+        // Drops leading zero limbs
+        void trim(vector<uint64_t> &limbs)
+        {
+            while (!limbs.empty() && limbs.back() == 0)
+            {
+                limbs.pop_back();
+            }
+        }
+    }
+
+    /**
+     * Constructs a BigInt from a floating-point number, truncating toward zero.
+     * @throws std::invalid_argument If the number is not finite
+     */
+    BigInt::BigInt(double value) : small(0), negative(false)
+    {
+        if (!isfinite(value))
+        {
+                throw invalid_argument("BigInt cannot hold a non-finite value.");
+        }
+
+        double magnitude = trunc(fabs(value));
+        if (magnitude < 18446744073709551616.0)
+        {
+                small = static_cast<uint64_t>(magnitude);
+        }
+        else
+        {
+                // magnitude = mantissa * 2^exponent with a 53-bit integer mantissa
+                int exponent = 0;
+                double fraction = frexp(magnitude, &exponent);
+                BigInt result(static_cast<long long>(ldexp(fraction, 53)));
+                for (exponent -= 53; exponent > 0; exponent -= 32)
+                {
+                    result *= BigInt(1LL << min(exponent, 32));
+                }
+                *this = result;
+        }
+        negative = value < 0 && !is_zero();
+    }
+
+    // Narrowing conversion to __int128 (low 128 bits, two's complement)
+    BigInt::operator __int128() const
+    {
+        uint128 magnitude = small;
+        if (!limbs.empty())
+        {
+                magnitude = (uint128(limbs[1]) << 64) | limbs[0];
+        }
+        return static_cast<__int128>(negative ? 0 - magnitude : magnitude);
+    }
+
+    // True when the value is stored inline (magnitude below 2^64)
+    bool BigInt::is_small() const
+    {
+        return limbs.empty();
+    }
+
+    bool BigInt::is_zero() const
+    {
+        return limbs.empty() && small == 0;
+    }
+
+    bool BigInt::is_negative() const
+    {
+        return negative;
+    }
+
+    /**
+     * Views the magnitude as limbs, least significant first (empty for zero); an inline value is one limb.
+     */
+    BigInt::Magnitude BigInt::magnitude() const
+    {
+        if (!limbs.empty())
+                return limbs;
+        return Magnitude(&small, small == 0 ? 0 : 1);
+    }
+
+    /**
+     * Stores a magnitude and sign, moving the value inline when it fits in one limb.
+     */
+    void BigInt::assign(Limbs &&magnitude, bool is_negative)
+    {
+        small = 0;
+        limbs = move(magnitude);
+        negative = is_negative;
+        normalize();
+    }
+
+    /**
+     * Restores the representation after the limbs changed: drops leading zero limbs, moves the value
+     * inline when it fits in one limb and clears the sign of zero.
+     */
+    void BigInt::normalize()
+    {
+        trim(limbs);
+        if (limbs.size() <= 1)
+        {
+                small = limbs.empty() ? 0 : limbs[0];
+                limbs.clear();
+                limbs.shrink_to_fit();
+        }
+        negative = negative && !is_zero();
+    }
+
+    /**
+     * Compares the magnitudes of two numbers, returning -1, 0 or 1.
+     */
+    int BigInt::compare_magnitude(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty())
+                return num1.small < num2.small ? -1 : (num1.small > num2.small ? 1 : 0);
+        if (num1.limbs.size() != num2.limbs.size())
+                return num1.limbs.size() < num2.limbs.size() ? -1 : 1;
+
+        for (size_t i = num1.limbs.size(); i-- > 0;)
+        {
+                if (num1.limbs[i] != num2.limbs[i])
+                    return num1.limbs[i] < num2.limbs[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    BigInt::Limbs BigInt::add_magnitude(Magnitude num1, Magnitude num2)
+    {
+        const Magnitude longer = num1.size() >= num2.size() ? num1 : num2;
+        const Magnitude shorter = num1.size() >= num2.size() ? num2 : num1;
+        Limbs result(longer.size() + 1, 0);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < longer.size(); ++i)
+        {
+                uint128 sum = uint128(longer[i]) + (i < shorter.size() ? shorter[i] : 0) + carry;
+                result[i] = static_cast<uint64_t>(sum);
+                carry = static_cast<uint64_t>(sum >> 64);
+        }
+        result[longer.size()] = carry;
+        return result;
+    }
+
+    // Requires |larger| >= |smaller|
+    BigInt::Limbs BigInt::subtract_magnitude(Magnitude larger, Magnitude smaller)
+    {
+        Limbs result(larger.size(), 0);
+        uint64_t borrow = 0;
+        for (size_t i = 0; i < larger.size(); ++i)
+        {
+                const uint64_t subtrahend = i < smaller.size() ? smaller[i] : 0;
+                const uint128 difference = uint128(larger[i]) - subtrahend - borrow;
+                result[i] = static_cast<uint64_t>(difference);
+                borrow = (difference >> 64) != 0 ? 1 : 0;
+        }
+        return result;
+    }
+
+    BigInt::Limbs BigInt::multiply_magnitude(Magnitude num1, Magnitude num2)
+    {
+        if (num1.empty() || num2.empty())
+                return {};
+
+        Limbs result(num1.size() + num2.size(), 0);
+        for (size_t i = 0; i < num1.size(); ++i)
+        {
+                uint64_t carry = 0;
+                for (size_t j = 0; j < num2.size(); ++j)
+                {
+                    uint128 product = uint128(num1[i]) * num2[j] + result[i + j] + carry;
+                    result[i + j] = static_cast<uint64_t>(product);
+                    carry = static_cast<uint64_t>(product >> 64);
+                }
+                result[i + num2.size()] = carry;
+        }
+        return result;
+    }
+
+    /**
+     * Divides a magnitude in place by a single limb and returns the remainder.
+     */
+    uint64_t BigInt::divide_small(Limbs &num, uint64_t divisor)
+    {
+        uint128 remainder = 0;
+        for (size_t i = num.size(); i-- > 0;)
+        {
+                uint128 current = (remainder << 64) | num[i];
+                num[i] = static_cast<uint64_t>(current / divisor);
+                remainder = current % divisor;
+        }
+        trim(num);
+        return static_cast<uint64_t>(remainder);
+    }
+
+    /**
+     * Remainder of a magnitude divided by a single limb, without computing the quotient.
+     */
+    uint64_t BigInt::remainder_small(Magnitude num, uint64_t divisor)
+    {
+        uint128 remainder = 0;
+        for (size_t i = num.size(); i-- > 0;)
+        {
+                remainder = ((remainder << 64) | num[i]) % divisor;
+        }
+        return static_cast<uint64_t>(remainder);
+    }
+
+    /**
+     * Long division of magnitudes (Knuth, TAOCP vol. 2, algorithm D) with 64-bit limbs.
+     * Returns the quotient and stores the remainder. The divisor must be non-zero.
+     */
+    BigInt::Limbs BigInt::divide_magnitude(Magnitude num1, Magnitude num2, Limbs &remainder)
+    {
+        if (num1.size() < num2.size())
+        {
+                remainder.assign(num1.begin(), num1.end());
+                return {};
+        }
+        if (num2.size() == 1)
+        {
+                Limbs quotient(num1.begin(), num1.end());
+                remainder = {divide_small(quotient, num2[0])};
+                trim(remainder);
+                return quotient;
+        }
+
+        // Normalize so that the top limb of the divisor has its high bit set
+        const size_t len = num2.size();
+        const size_t steps = num1.size() - len;
+        const int shift = __builtin_clzll(num2.back());
+        Limbs divisor(len);
+        Limbs dividend(num1.size() + 1);
+        for (size_t i = len; i-- > 0;)
+        {
+                divisor[i] = (num2[i] << shift) | (shift != 0 && i > 0 ? num2[i - 1] >> (64 - shift) : 0);
+        }
+        dividend[num1.size()] = shift != 0 ? num1.back() >> (64 - shift) : 0;
+        for (size_t i = num1.size(); i-- > 0;)
+        {
+                dividend[i] = (num1[i] << shift) | (shift != 0 && i > 0 ? num1[i - 1] >> (64 - shift) : 0);
+        }
+
+        Limbs quotient(steps + 1, 0);
+        for (size_t j = steps + 1; j-- > 0;)
+        {
+                // Estimate the quotient limb from the top two limbs, then correct it at most twice
+                const uint128 top = (uint128(dividend[j + len]) << 64) | dividend[j + len - 1];
+                uint128 estimate = top / divisor[len - 1];
+                uint128 rest = top % divisor[len - 1];
+                while ((estimate >> 64) != 0 ||
+                       estimate * divisor[len - 2] > ((rest << 64) | dividend[j + len - 2]))
+                {
+                    --estimate;
+                    rest += divisor[len - 1];
+                    if ((rest >> 64) != 0)
+                        break;
+                }
+
+                // Multiply and subtract
+                __int128 borrow = 0;
+                __int128 difference = 0;
+                for (size_t i = 0; i < len; ++i)
+                {
+                    const uint128 product = estimate * divisor[i];
+                    difference = __int128(dividend[i + j]) - borrow - __int128(static_cast<uint64_t>(product));
+                    dividend[i + j] = static_cast<uint64_t>(difference);
+                    borrow = __int128(product >> 64) - (difference >> 64);
+                }
+                difference = __int128(dividend[j + len]) - borrow;
+                dividend[j + len] = static_cast<uint64_t>(difference);
+
+                quotient[j] = static_cast<uint64_t>(estimate);
+                if (difference < 0)
+                {
+                    // The estimate was one too large; add the divisor back
+                    --quotient[j];
+                    uint64_t carry = 0;
+                    for (size_t i = 0; i < len; ++i)
+                    {
+                        const uint128 sum = uint128(dividend[i + j]) + divisor[i] + carry;
+                        dividend[i + j] = static_cast<uint64_t>(sum);
+                        carry = static_cast<uint64_t>(sum >> 64);
+                    }
+                    dividend[j + len] += carry;
+                }
+        }
+
+        remainder.assign(len, 0);
+        for (size_t i = 0; i < len; ++i)
+        {
+                remainder[i] = (dividend[i] >> shift) | (shift != 0 ? dividend[i + 1] << (64 - shift) : 0);
+        }
+        trim(remainder);
+        trim(quotient);
+        return quotient;
+    }
+
+    /**
+     * Adds num2 (or its negation) to num1: the general case of + and -, for heap operands
+     * and for inline sums that carry into a second limb.
+     */
+    BigInt BigInt::add_signed(const BigInt &num1, const BigInt &num2, bool negate_second)
+    {
+        const bool second_negative = num2.negative != negate_second && !num2.is_zero();
+        BigInt result;
+        if (num1.negative == second_negative)
+        {
+                result.assign(add_magnitude(num1.magnitude(), num2.magnitude()), num1.negative);
+        }
+        else if (compare_magnitude(num1, num2) >= 0)
+        {
+                result.assign(subtract_magnitude(num1.magnitude(), num2.magnitude()), num1.negative);
+        }
+        else
+        {
+                result.assign(subtract_magnitude(num2.magnitude(), num1.magnitude()), second_negative);
+        }
+        return result;
+    }
+
+    // General case of *: at least one heap operand, or an inline product that needs a second limb
+    BigInt BigInt::multiply_signed(const BigInt &num1, const BigInt &num2)
+    {
+        BigInt result;
+        result.assign(multiply_magnitude(num1.magnitude(), num2.magnitude()), num1.negative != num2.negative);
+        return result;
+    }
+
+    /**
+     * Truncating division, the general case of /.
+     * @throws std::runtime_error If the divisor is zero
+     */
+    BigInt BigInt::divide_signed(const BigInt &num1, const BigInt &num2)
+    {
+        if (num2.is_zero())
+        {
+                throw runtime_error("Cannot divide by zero.");
+        }
+
+        BigInt result;
+        Limbs remainder;
+        result.assign(divide_magnitude(num1.magnitude(), num2.magnitude(), remainder), num1.negative != num2.negative);
+        return result;
+    }
+
+    /**
+     * Remainder of the truncating division, the general case of %; takes the sign of the dividend.
+     * @throws std::runtime_error If the divisor is zero
+     */
+    BigInt BigInt::remainder_signed(const BigInt &num1, const BigInt &num2)
+    {
+        if (num2.is_zero())
+        {
+                throw runtime_error("Cannot divide by zero.");
+        }
+
+        if (num2.limbs.empty())
+                return BigInt(remainder_small(num1.magnitude(), num2.small), num1.negative);
+        BigInt result;
+        Limbs remainder;
+        divide_magnitude(num1.magnitude(), num2.magnitude(), remainder);
+        result.assign(move(remainder), num1.negative);
+        return result;
+    }
+
+    BigInt BigInt::operator-() const
+    {
+        BigInt result = *this;
+        result.negative = !negative && !is_zero();
+        return result;
+    }
+
+    /**
+     * Adds other (or its negation) to a heap value by updating its limbs in place: the general case of
+     * += and -=. An inline value that carries into a second limb needs a new buffer anyway and, like
+     * adding a number to itself, goes through add_signed.
+     */
+    void BigInt::add_in_place(const BigInt &other, bool negate_second)
+    {
+        if (limbs.empty() || this == &other)
+        {
+                *this = add_signed(*this, other, negate_second);
+                return;
+        }
+
+        const bool other_negative = other.negative != negate_second && !other.is_zero();
+        const Magnitude addend = other.magnitude();
+        if (negative == other_negative)
+        {
+                if (limbs.size() < addend.size())
+                    limbs.resize(addend.size(), 0);
+                uint64_t carry = 0;
+                for (size_t i = 0; i < limbs.size() && (i < addend.size() || carry != 0); ++i)
+                {
+                    const uint128 sum = uint128(limbs[i]) + (i < addend.size() ? addend[i] : 0) + carry;
+                    limbs[i] = static_cast<uint64_t>(sum);
+                    carry = static_cast<uint64_t>(sum >> 64);
+                }
+                if (carry != 0)
+                    limbs.push_back(carry);
+        }
+        else
+        {
+                // The smaller magnitude is subtracted from the larger one, whose sign the result takes
+                const bool larger = compare_magnitude(*this, other) >= 0;
+                if (!larger)
+                {
+                    limbs.resize(addend.size(), 0);
+                    negative = other_negative;
+                }
+                uint64_t borrow = 0;
+                for (size_t i = 0; i < limbs.size() && (i < addend.size() || borrow != 0); ++i)
+                {
+                    const uint64_t subtrahend = i < addend.size() ? addend[i] : 0;
+                    const uint128 difference = larger ? uint128(limbs[i]) - subtrahend - borrow : uint128(subtrahend) - limbs[i] - borrow;
+                    limbs[i] = static_cast<uint64_t>(difference);
+                    borrow = (difference >> 64) != 0 ? 1 : 0;
+                }
+        }
+        normalize();
+    }
+
+    /**
+     * Multiplies a heap value by a single limb in place: the general case of *=. Other products read every
+     * limb of both factors until the end, so they are computed into a new buffer by multiply_signed.
+     */
+    void BigInt::multiply_in_place(const BigInt &other)
+    {
+        if (limbs.empty() || !other.limbs.empty() || other.small == 0)
+        {
+                *this = multiply_signed(*this, other);
+                return;
+        }
+
+        uint64_t carry = 0;
+        for (uint64_t &limb : limbs)
+        {
+                const uint128 product = uint128(limb) * other.small + carry;
+                limb = static_cast<uint64_t>(product);
+                carry = static_cast<uint64_t>(product >> 64);
+        }
+        if (carry != 0)
+                limbs.push_back(carry);
+        negative = negative != other.negative;
+    }
+
+    /**
+     * Divides a heap value by a single limb in place: the general case of /=. Longer divisors go through
+     * divide_signed.
+     * @throws std::runtime_error If the divisor is zero
+     */
+    void BigInt::divide_in_place(const BigInt &other)
+    {
+        if (limbs.empty() || !other.limbs.empty() || other.small == 0)
+        {
+                *this = divide_signed(*this, other);
+                return;
+        }
+
+        divide_small(limbs, other.small);
+        negative = negative != other.negative;
+        normalize();
+    }
+
+    bool operator!=(const BigInt &num1, const BigInt &num2)
+    {
+        return !(num1 == num2);
+    }
+
+    bool operator>(const BigInt &num1, const BigInt &num2)
+    {
+        return num2 < num1;
+    }
+
+    bool operator<=(const BigInt &num1, const BigInt &num2)
+    {
+        return !(num2 < num1);
+    }
+
+    bool operator>=(const BigInt &num1, const BigInt &num2)
+    {
+        return !(num1 < num2);
+    }
+
+    /**
+     * Returns the decimal representation, converting 19 digits per limb division.
+     */
+    string BigInt::to_string() const
+    {
+        if (limbs.empty())
+                return (negative ? "-" : "") + std::to_string(small);
+
+        Limbs rest = limbs;
+        string digits;
+        while (!rest.empty())
+        {
+                string chunk = std::to_string(divide_small(rest, DECIMAL_BASE));
+                if (!rest.empty())
+                    chunk.insert(0, static_cast<size_t>(DECIMAL_DIGITS) - chunk.size(), '0');
+                digits.insert(0, chunk);
+        }
+        return (negative ? "-" : "") + digits;
+    }
+
+    // Overloaded output operator <<
+    ostream &operator<<(ostream &output, const BigInt &number)
+    {
+        return output << number.to_string();
+    }
+
+    // Overloaded input operator >>, reads an optionally signed decimal integer and sets failbit otherwise
+    istream &operator>>(istream &input, BigInt &number)
+    {
+        input >> ws;
+        const bool negative = input.peek() == '-';
+        if (negative || input.peek() == '+')
+                input.get();
+
+        BigInt result;
+        bool any_digit = false;
+        while (isdigit(input.peek()) != 0)
+        {
+                result = result * BigInt(10) + BigInt(input.get() - '0');
+                any_digit = true;
+        }
+
+        if (!any_digit)
+        {
+                input.setstate(ios::failbit);
+                return input;
+        }
+        number = negative ? -result : result;
+        return input;
+    }
+
+    /**
+     * Greatest common divisor when at least one operand is on the heap (two inline values use the binary
+     * engine from Gcd.hpp directly). A single-limb operand needs one remainder to bring the other inline;
+     * otherwise Euclid's algorithm runs until both are small enough to switch over.
+     */
+    BigInt BigInt::gcd_signed(const BigInt &num1, const BigInt &num2)
+    {
+        BigInt result;
+        if (num1.limbs.empty() != num2.limbs.empty())
+        {
+                const BigInt &inline_value = num1.limbs.empty() ? num1 : num2;
+                const BigInt &heap_value = num1.limbs.empty() ? num2 : num1;
+                if (inline_value.small == 0)
+                    return heap_value.negative ? -heap_value : heap_value;
+                result.small = binary_gcd(inline_value.small, remainder_small(heap_value.magnitude(), inline_value.small));
+                return result;
+        }
+
+        BigInt first = num1.negative ? -num1 : num1;
+        BigInt second = num2.negative ? -num2 : num2;
+        while (!second.limbs.empty() || !first.limbs.empty())
+        {
+                if (second.is_zero())
+                    return first;
+                BigInt rest = first % second;
+                first = move(second);
+                second = move(rest);
+        }
+        result.small = binary_gcd(first.small, second.small);
+        return result;
+    }
+
+    // Bits of the most significant limb plus 64 for every limb below it
+    int bit_length(const BigInt &number)
+    {
+        if (number.limbs.empty())
+                return bit_length(static_cast<unsigned __int128>(number.small));
+        return static_cast<int>(64 * (number.limbs.size() - 1)) + bit_length(static_cast<unsigned __int128>(number.limbs.back()));
+    }
+
+};
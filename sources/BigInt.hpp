@@ -0,0 +1,300 @@
+#ifndef BIGINT_HPP
+#define BIGINT_HPP
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Gcd.hpp"
+
+using namespace std;
+
+namespace ariel
+{
+    // Arbitrary-precision signed integer used as the backing type of BigFraction.
+    // Values whose magnitude fits in 64 bits are stored inline and never allocate;
+    // only values that outgrow one limb move to the heap. The operations on two inline values
+    // are defined in this header so that they inline like the built-in types' arithmetic.
+    class BigInt
+    {
+    private:
+        using Limbs = vector<uint64_t>;
+
+        // Magnitude below 2^64, valid while limbs is empty
+        uint64_t small;
+        // Magnitude of larger values, least significant limb first (at least two limbs)
+        Limbs limbs;
+        bool negative;
+
+        using Magnitude = span<const uint64_t>;
+
+        // Inline value with the given magnitude (the sign is dropped for 0)
+        BigInt(uint64_t magnitude, bool is_negative) : small(magnitude), negative(is_negative && magnitude != 0) {}
+
+        // Helper functions on magnitudes; magnitude() views the limbs without copying them (empty for zero)
+        Magnitude magnitude() const;
+        void assign(Limbs &&magnitude, bool is_negative);
+        void normalize();
+        static int compare_magnitude(const BigInt &num1, const BigInt &num2);
+        static Limbs add_magnitude(Magnitude num1, Magnitude num2);
+        static Limbs subtract_magnitude(Magnitude larger, Magnitude smaller);
+        static Limbs multiply_magnitude(Magnitude num1, Magnitude num2);
+        static Limbs divide_magnitude(Magnitude num1, Magnitude num2, Limbs &remainder);
+        static uint64_t divide_small(Limbs &num, uint64_t divisor);
+        static uint64_t remainder_small(Magnitude num, uint64_t divisor);
+
+        // General cases of the operators, for operands that are not both inline
+        static BigInt add_signed(const BigInt &num1, const BigInt &num2, bool negate_second);
+        static BigInt multiply_signed(const BigInt &num1, const BigInt &num2);
+        static BigInt divide_signed(const BigInt &num1, const BigInt &num2);
+        static BigInt remainder_signed(const BigInt &num1, const BigInt &num2);
+        static BigInt gcd_signed(const BigInt &num1, const BigInt &num2);
+
+        // General cases of the compound operators, updating the heap limbs in place where they can
+        void add_in_place(const BigInt &other, bool negate_second);
+        void multiply_in_place(const BigInt &other);
+        void divide_in_place(const BigInt &other);
+
+    public:
+        // constructor
+        BigInt() : small(0), negative(false) {}
+        BigInt(long long value) : small(value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value)), negative(value < 0) {}
+        BigInt(__int128 value);
+        explicit BigInt(double value);
+
+        // Any other signed built-in integer, so that e.g. BigInt(10) does not also match BigInt(double)
+        template <typename IntT, typename = enable_if_t<is_integral_v<IntT> && is_signed_v<IntT>>>
+        BigInt(IntT value) : BigInt(static_cast<long long>(value)) {}
+
+        // Narrowing conversion; like the built-in conversions it keeps the low-order bits when the value does not fit
+        explicit operator __int128() const;
+
+        // True when the value is stored inline (magnitude below 2^64)
+        bool is_small() const;
+        bool is_zero() const;
+        bool is_negative() const;
+
+        // Decimal representation
+        string to_string() const;
+
+        // Friend operators for arithmetic operations; / and % truncate toward zero like the built-in types
+        friend BigInt operator+(const BigInt &num1, const BigInt &num2);
+        friend BigInt operator-(const BigInt &num1, const BigInt &num2);
+        friend BigInt operator*(const BigInt &num1, const BigInt &num2);
+        friend BigInt operator/(const BigInt &num1, const BigInt &num2);
+        friend BigInt operator%(const BigInt &num1, const BigInt &num2);
+        BigInt operator-() const;
+
+        BigInt &operator+=(const BigInt &other);
+        BigInt &operator-=(const BigInt &other);
+        BigInt &operator*=(const BigInt &other);
+        BigInt &operator/=(const BigInt &other);
+
+        // Friend operators for comparison operations
+        friend bool operator==(const BigInt &num1, const BigInt &num2);
+        friend bool operator!=(const BigInt &num1, const BigInt &num2);
+        friend bool operator<(const BigInt &num1, const BigInt &num2);
+        friend bool operator>(const BigInt &num1, const BigInt &num2);
+        friend bool operator<=(const BigInt &num1, const BigInt &num2);
+        friend bool operator>=(const BigInt &num1, const BigInt &num2);
+
+        // Overloaded operators for input and output operations
+        friend ostream &operator<<(ostream &output, const BigInt &number);
+        friend istream &operator>>(istream &input, BigInt &number);
+
+        // Greatest common divisor, always non-negative (the BigInt overload of Gcd.hpp's fraction_gcd)
+        friend BigInt fraction_gcd(const BigInt &num1, const BigInt &num2);
+        // Number of significant bits of the magnitude (the BigInt overload of Gcd.hpp's bit_length)
+        friend int bit_length(const BigInt &number);
+    };
+
+    BigInt fraction_gcd(const BigInt &num1, const BigInt &num2);
+    int bit_length(const BigInt &number);
+
+    /**
+     * Constructs a BigInt from a 128-bit integer; only magnitudes of 2^64 and above use a second limb on the heap.
+     */
+    inline BigInt::BigInt(__int128 value) : small(0), negative(false)
+    {
+        const unsigned __int128 magnitude = value < 0 ? 0 - static_cast<unsigned __int128>(value) : static_cast<unsigned __int128>(value);
+        if ((magnitude >> 64) == 0)
+        {
+                small = static_cast<uint64_t>(magnitude);
+                negative = value < 0;
+                return;
+        }
+        assign({static_cast<uint64_t>(magnitude), static_cast<uint64_t>(magnitude >> 64)}, value < 0);
+    }
+
+    // Fast paths for two inline operands whose result fits one limb; the rest is in BigInt.cpp
+    inline BigInt operator+(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty())
+        {
+                uint64_t sum = 0;
+                if (num1.negative != num2.negative)
+                    return num1.small >= num2.small ? BigInt(num1.small - num2.small, num1.negative) : BigInt(num2.small - num1.small, num2.negative);
+                if (!__builtin_add_overflow(num1.small, num2.small, &sum))
+                    return BigInt(sum, num1.negative);
+        }
+        return BigInt::add_signed(num1, num2, false);
+    }
+
+    inline BigInt operator-(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty())
+        {
+                uint64_t sum = 0;
+                if (num1.negative == num2.negative)
+                    return num1.small >= num2.small ? BigInt(num1.small - num2.small, num1.negative) : BigInt(num2.small - num1.small, !num2.negative);
+                if (!__builtin_add_overflow(num1.small, num2.small, &sum))
+                    return BigInt(sum, num1.negative);
+        }
+        return BigInt::add_signed(num1, num2, true);
+    }
+
+    inline BigInt operator*(const BigInt &num1, const BigInt &num2)
+    {
+        uint64_t product = 0;
+        if (num1.limbs.empty() && num2.limbs.empty() && !__builtin_mul_overflow(num1.small, num2.small, &product))
+                return BigInt(product, num1.negative != num2.negative);
+        return BigInt::multiply_signed(num1, num2);
+    }
+
+    inline BigInt operator/(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty() && num2.small != 0)
+                return BigInt(num1.small / num2.small, num1.negative != num2.negative);
+        return BigInt::divide_signed(num1, num2);
+    }
+
+    inline BigInt operator%(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty() && num2.small != 0)
+                return BigInt(num1.small % num2.small, num1.negative);
+        return BigInt::remainder_signed(num1, num2);
+    }
+
+    // In-place fast paths for two inline operands; the general cases in BigInt.cpp reuse the heap limbs
+    inline BigInt &BigInt::operator+=(const BigInt &other)
+    {
+        if (limbs.empty() && other.limbs.empty())
+        {
+                uint64_t sum = 0;
+                if (negative != other.negative)
+                {
+                    if (small >= other.small)
+                        small -= other.small;
+                    else
+                    {
+                        small = other.small - small;
+                        negative = other.negative;
+                    }
+                    negative = negative && small != 0;
+                    return *this;
+                }
+                if (!__builtin_add_overflow(small, other.small, &sum))
+                {
+                    small = sum;
+                    return *this;
+                }
+        }
+        add_in_place(other, false);
+        return *this;
+    }
+
+    inline BigInt &BigInt::operator-=(const BigInt &other)
+    {
+        if (limbs.empty() && other.limbs.empty())
+        {
+                uint64_t sum = 0;
+                if (negative == other.negative)
+                {
+                    if (small >= other.small)
+                        small -= other.small;
+                    else
+                    {
+                        small = other.small - small;
+                        negative = !negative;
+                    }
+                    negative = negative && small != 0;
+                    return *this;
+                }
+                if (!__builtin_add_overflow(small, other.small, &sum))
+                {
+                    small = sum;
+                    return *this;
+                }
+        }
+        add_in_place(other, true);
+        return *this;
+    }
+
+    inline BigInt &BigInt::operator*=(const BigInt &other)
+    {
+        uint64_t product = 0;
+        if (limbs.empty() && other.limbs.empty() && !__builtin_mul_overflow(small, other.small, &product))
+        {
+                small = product;
+                negative = negative != other.negative && product != 0;
+                return *this;
+        }
+        multiply_in_place(other);
+        return *this;
+    }
+
+    inline BigInt &BigInt::operator/=(const BigInt &other)
+    {
+        if (limbs.empty() && other.limbs.empty() && other.small != 0)
+        {
+                small /= other.small;
+                negative = negative != other.negative && small != 0;
+                return *this;
+        }
+        divide_in_place(other);
+        return *this;
+    }
+
+    inline bool operator==(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty())
+                return num1.small == num2.small && num1.negative == num2.negative;
+        return num1.negative == num2.negative && BigInt::compare_magnitude(num1, num2) == 0;
+    }
+
+    inline bool operator<(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.negative != num2.negative)
+                return num1.negative;
+        if (num1.limbs.empty() && num2.limbs.empty())
+                return num1.negative ? num1.small > num2.small : num1.small < num2.small;
+        const int order = BigInt::compare_magnitude(num1, num2);
+        return num1.negative ? order > 0 : order < 0;
+    }
+
+    inline BigInt fraction_gcd(const BigInt &num1, const BigInt &num2)
+    {
+        if (num1.limbs.empty() && num2.limbs.empty())
+                return BigInt(binary_gcd(num1.small, num2.small), false);
+        return BigInt::gcd_signed(num1, num2);
+    }
+
+};
+
+// BigInt is an unbounded integer; BasicFraction uses is_bounded to skip its overflow checks.
+namespace std
+{
+    template <>
+    struct numeric_limits<ariel::BigInt>
+    {
+        static constexpr bool is_specialized = true;
+        static constexpr bool is_signed = true;
+        static constexpr bool is_integer = true;
+        static constexpr bool is_exact = true;
+        static constexpr bool is_bounded = false;
+    };
+};
+
+#endif // BIGINT_HPP
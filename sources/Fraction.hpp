@@ -1,69 +1,1471 @@
-
 #ifndef FRACTION_HPP
 #define FRACTION_HPP
 #include <iostream>
 #include <stdexcept>
 #include <limits>
+#include <span>
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <cstdint>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <compare>
+#include <type_traits>
+#include "BigInt.hpp"
+#include "Gcd.hpp"
+#include "Overflow.hpp"
 
 using namespace std;
 
 namespace ariel
 {
-    class Fraction
+    // Failure reported by the non-throwing (checked_*) API instead of an exception
+    enum class FractionError
+    {
+        none,
+        overflow,         // overflow_error in the throwing API
+        zero_denominator, // invalid_argument
+        division_by_zero  // runtime_error
+    };
+
+    // Expected-like result of the non-throwing API: value is meaningful only when ok()
+    template <typename T>
+    struct Checked
+    {
+        T value;
+        FractionError error = FractionError::none;
+
+        constexpr bool ok() const { return error == FractionError::none; }
+        constexpr explicit operator bool() const { return ok(); }
+    };
+
+    template <typename IntT>
+    class BasicFractionColumn;
+
+    template <typename IntT>
+    class BasicLazyFraction;
+
+    // A fraction backed by the integer type IntT.
+    // Every member is defined below the class: the arithmetic core is constexpr, so it can be evaluated at
+    // compile time and inlined into callers. Fraction.cpp instantiates the class for int, int64_t and __int128,
+    // BigFraction.cpp for BigInt.
+    template <typename IntT>
+    class BasicFraction
     {
     private:
-        int numerator;
-        int denominator;
+        IntT numerator;
+        IntT denominator;
+
+        // The column container stores the same normalized terms and reuses the batch kernels
+        friend class BasicFractionColumn<IntT>;
+        // The lazily normalized type hands out its reduced terms without another gcd
+        friend class BasicLazyFraction<IntT>;
+
+        // Tag selecting the constructor that trusts its arguments to already be in lowest terms
+        // with a positive denominator, so it skips the zero check, the sign flip and reduce()
+        struct normalized
+        {
+        };
+        constexpr BasicFraction(IntT numerator, IntT denominator, normalized);
+
+        // Non-throwing implementations of the arithmetic; on success they store the result and return FractionError::none
+        static constexpr FractionError try_normalize(IntT &numerator, IntT &denominator);
+        static constexpr FractionError try_add_or_subtract(const BasicFraction &num1, const BasicFraction &num2, char op, BasicFraction &result);
+        static constexpr FractionError try_add_or_subtract_wide(const BasicFraction &num1, const BasicFraction &num2, char op, IntT my_gcd, BasicFraction &result);
+        static constexpr FractionError try_multiply(const BasicFraction &num1, const BasicFraction &num2, BasicFraction &result);
+        static constexpr FractionError try_divide(const BasicFraction &num1, const BasicFraction &num2, BasicFraction &result);
+        static constexpr FractionError try_multiply_add(const BasicFraction &num1, const BasicFraction &num2, const BasicFraction &num3, BasicFraction &result);
+        static constexpr void throw_if_error(FractionError error);
+
+        // Implementations of the friend operators below
+        static constexpr BasicFraction add_or_subtract(const BasicFraction &num1, const BasicFraction &num2, char op);
+        static constexpr BasicFraction multiply(const BasicFraction &num1, const BasicFraction &num2);
+        static constexpr BasicFraction divide(const BasicFraction &num1, const BasicFraction &num2);
+        static constexpr BasicFraction multiply_add(const BasicFraction &num1, const BasicFraction &num2, const BasicFraction &num3);
+        static constexpr bool equal(const BasicFraction &num1, const BasicFraction &num2);
+        static constexpr int compare(const BasicFraction &num1, const BasicFraction &num2);
+        static constexpr int compare_continued_fraction(IntT num_1, IntT den_1, IntT num_2, IntT den_2);
+
+        // Compound assignment for unbounded types, which cannot overflow: the terms are updated with IntT's
+        // own compound operators, so their storage is reused instead of replaced
+        constexpr void add_or_subtract_in_place(const BasicFraction &other, char op);
+        constexpr void multiply_in_place(const BasicFraction &other);
+        constexpr void divide_in_place(const BasicFraction &other);
+
+        // Continued-fraction search behind from_double, run in a type wide enough for the exact value
+        template <typename WideT>
+        static constexpr BasicFraction best_approximation(const BasicFraction<WideT> &exact, IntT max_denominator);
+
+        // Shared implementation of to_double and to_float
+        template <typename FloatT>
+        FloatT to_floating() const;
+
+        // Shared loop of the batch operations: lhs(i) and rhs(i) return the operands of element i,
+        // store(i, numerator, denominator) receives its normalized result
+        template <char Op, typename LhsAt, typename RhsAt, typename Store>
+        static void batch_apply(size_t count, LhsAt lhs, RhsAt rhs, Store store);
+        template <char Op>
+        static void batch_apply(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out);
+        template <char Op>
+        static void batch_apply(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out);
+        static void check_batch_sizes(size_t lhs_size, size_t rhs_size, size_t out_size);
+
+        // Mixed-type operands: the float constructor's value n/1000, where n = scale(num)
+        static constexpr IntT scale(double num);
+        static constexpr BasicFraction from_scaled(IntT scaled);
+        static constexpr int compare_scaled(const BasicFraction &num1, IntT scaled);
+        static ostream &write(ostream &output, const BasicFraction &fraction);
+        static istream &read(istream &input, BasicFraction &fraction);
 
     public:
+        using value_type = IntT;
+
         // Helper function to reduce the fraction
-        void reduce();
+        constexpr void reduce();
 
         // constructor
-        Fraction();
-        Fraction(int numerator, int denominator);
-        Fraction(float num);
-        Fraction(const Fraction &other);
-        Fraction(Fraction &&other) noexcept;
+        constexpr BasicFraction();
+        constexpr BasicFraction(IntT numerator, IntT denominator);
+        constexpr BasicFraction(float num);
+
+        // The exact value of a finite double: its odd mantissa over a power of two, reduced by shifting.
+        // Throws overflow_error when a term does not fit IntT; BasicFraction(float) keeps the 3-digit conversion.
+        static constexpr BasicFraction from_double_exact(double num);
+
+        // The closest fraction to num whose denominator is at most max_denominator (continued fractions, O(log) steps).
+        // Throws invalid_argument if max_denominator < 1, and overflow_error if the numerator does not fit IntT.
+        static constexpr BasicFraction from_double(double num, IntT max_denominator);
+        constexpr BasicFraction(const BasicFraction &other);
+        constexpr BasicFraction(BasicFraction &&other) noexcept;
+
+        // Converts between backing types; the value must fit in IntT
+        template <typename OtherT>
+        constexpr explicit BasicFraction(const BasicFraction<OtherT> &other)
+            : numerator(static_cast<IntT>(other.getNumerator())), denominator(static_cast<IntT>(other.getDenominator())) {}
 
         // //destructor
-        ~Fraction() = default;
+        ~BasicFraction() = default;
 
-        Fraction &operator=(const Fraction &other);
-        Fraction &operator=(Fraction &&other) noexcept;
+        constexpr BasicFraction &operator=(const BasicFraction &other);
+        constexpr BasicFraction &operator=(BasicFraction &&other) noexcept;
 
         // Friend operators for arithmetic operations
-        const friend Fraction operator+(const Fraction &num1, const Fraction &num2);
-        const friend Fraction operator-(const Fraction &num1, const Fraction &num2);
-        const friend Fraction operator*(const Fraction &num1, const Fraction &num2);
-        const friend Fraction operator/(const Fraction &num1, const Fraction &num2);
-
-        // Friend operators for comparison operations
-        friend bool operator==(const Fraction &num1, const Fraction &num2);
-        friend bool operator!=(const Fraction &num1, const Fraction &num2);
-        friend bool operator>(const Fraction &num1, const Fraction &num2);
-        friend bool operator<(const Fraction &num1, const Fraction &num2);
-        friend bool operator>=(const Fraction &num1, const Fraction &num2);
-        friend bool operator<=(const Fraction &num1, const Fraction &num2);
+        friend constexpr BasicFraction operator+(const BasicFraction &num1, const BasicFraction &num2) { return add_or_subtract(num1, num2, '+'); }
+        friend constexpr BasicFraction operator-(const BasicFraction &num1, const BasicFraction &num2) { return add_or_subtract(num1, num2, '-'); }
+        friend constexpr BasicFraction operator*(const BasicFraction &num1, const BasicFraction &num2) { return multiply(num1, num2); }
+        friend constexpr BasicFraction operator/(const BasicFraction &num1, const BasicFraction &num2) { return divide(num1, num2); }
+
+        // Fused multiply-add: num1 * num2 + num3 over one common denominator with a single reduction
+        friend constexpr BasicFraction fma(const BasicFraction &num1, const BasicFraction &num2, const BasicFraction &num3) { return multiply_add(num1, num2, num3); }
+
+        // Compound assignment: computes like the operators and stores the result in this object.
+        // Throws like them, leaving the object unchanged.
+        constexpr BasicFraction &operator+=(const BasicFraction &other);
+        constexpr BasicFraction &operator-=(const BasicFraction &other);
+        constexpr BasicFraction &operator*=(const BasicFraction &other);
+        constexpr BasicFraction &operator/=(const BasicFraction &other);
+        constexpr BasicFraction &operator+=(double other) { return *this += from_scaled(scale(other)); }
+        constexpr BasicFraction &operator-=(double other) { return *this -= from_scaled(scale(other)); }
+        constexpr BasicFraction &operator*=(double other) { return *this *= from_scaled(scale(other)); }
+        constexpr BasicFraction &operator/=(double other) { return *this /= from_scaled(scale(other)); }
+
+        // Mixed arithmetic with floating-point operands; same results as converting them with BasicFraction(float),
+        // but the n/1000 operand is reduced by stripping its factors of 2 and 5 instead of a gcd
+        friend constexpr BasicFraction operator+(const BasicFraction &num1, double num2) { return add_or_subtract(num1, from_scaled(scale(num2)), '+'); }
+        friend constexpr BasicFraction operator+(double num1, const BasicFraction &num2) { return add_or_subtract(from_scaled(scale(num1)), num2, '+'); }
+        friend constexpr BasicFraction operator-(const BasicFraction &num1, double num2) { return add_or_subtract(num1, from_scaled(scale(num2)), '-'); }
+        friend constexpr BasicFraction operator-(double num1, const BasicFraction &num2) { return add_or_subtract(from_scaled(scale(num1)), num2, '-'); }
+        friend constexpr BasicFraction operator*(const BasicFraction &num1, double num2) { return multiply(num1, from_scaled(scale(num2))); }
+        friend constexpr BasicFraction operator*(double num1, const BasicFraction &num2) { return multiply(from_scaled(scale(num1)), num2); }
+        friend constexpr BasicFraction operator/(const BasicFraction &num1, double num2) { return divide(num1, from_scaled(scale(num2))); }
+        friend constexpr BasicFraction operator/(double num1, const BasicFraction &num2) { return divide(from_scaled(scale(num1)), num2); }
+
+        // Non-throwing arithmetic for hot loops: failures are returned in Checked::error instead of thrown
+        static constexpr Checked<BasicFraction> checked_create(IntT numerator, IntT denominator);
+        friend constexpr Checked<BasicFraction> checked_add(const BasicFraction &num1, const BasicFraction &num2)
+        {
+            Checked<BasicFraction> result;
+            result.error = try_add_or_subtract(num1, num2, '+', result.value);
+            return result;
+        }
+        friend constexpr Checked<BasicFraction> checked_subtract(const BasicFraction &num1, const BasicFraction &num2)
+        {
+            Checked<BasicFraction> result;
+            result.error = try_add_or_subtract(num1, num2, '-', result.value);
+            return result;
+        }
+        friend constexpr Checked<BasicFraction> checked_multiply(const BasicFraction &num1, const BasicFraction &num2)
+        {
+            Checked<BasicFraction> result;
+            result.error = try_multiply(num1, num2, result.value);
+            return result;
+        }
+        friend constexpr Checked<BasicFraction> checked_divide(const BasicFraction &num1, const BasicFraction &num2)
+        {
+            Checked<BasicFraction> result;
+            result.error = try_divide(num1, num2, result.value);
+            return result;
+        }
+
+        // Friend operators for comparison operations; the compiler rewrites != in terms of ==, and <, >, <=, >=
+        // in terms of <=>, so every comparison (including those made by std::sort or std::map) is a single compare()
+        friend constexpr bool operator==(const BasicFraction &num1, const BasicFraction &num2) { return equal(num1, num2); }
+        friend constexpr strong_ordering operator<=>(const BasicFraction &num1, const BasicFraction &num2) { return compare(num1, num2) <=> 0; }
+
+        // Mixed comparisons cross-multiply with the scaled integer directly, without building a fraction
+        friend constexpr bool operator==(const BasicFraction &num1, double num2) { return compare_scaled(num1, scale(num2)) == 0; }
+        friend constexpr strong_ordering operator<=>(const BasicFraction &num1, double num2) { return compare_scaled(num1, scale(num2)) <=> 0; }
 
         // Overloaded operators for increment and decrement operations
-        Fraction operator++();          // pre-increment
-        const Fraction operator++(int); // post-increment
-        Fraction operator--();          // pre-decrement
-        const Fraction operator--(int); // post-decrement
+        constexpr BasicFraction &operator++();   // pre-increment
+        constexpr BasicFraction operator++(int); // post-increment
+        constexpr BasicFraction &operator--();   // pre-decrement
+        constexpr BasicFraction operator--(int); // post-decrement
 
         // Overloaded operators for input and output operations
-        friend ostream &operator<<(ostream &output, const Fraction &fraction);
-        friend istream &operator>>(istream &input, Fraction &fraction);
+        friend ostream &operator<<(ostream &output, const BasicFraction &fraction) { return write(output, fraction); }
+        friend istream &operator>>(istream &input, BasicFraction &fraction) { return read(input, fraction); }
+
+        // Conversion to floating point, correctly rounded (to nearest, ties to even) for int and int64_t terms.
+        // Fraction128 and BigFraction round the same way unless the result is subnormal.
+        double to_double() const;
+        float to_float() const;
+
+        // Array variants: converts fractions[i] into out[i] in one pass; out must be at least as long as fractions
+        static void to_double(span<const BasicFraction> fractions, span<double> out);
+        static void to_float(span<const BasicFraction> fractions, span<float> out);
+
+        // Batch arithmetic over arrays: out[i] = lhs[i] op rhs[i], or lhs[i] op rhs for a single fraction.
+        // out may be lhs or rhs itself. Throws like the operators; out is then left partly updated.
+        static void batch_add(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out);
+        static void batch_add(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out);
+        static void batch_subtract(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out);
+        static void batch_subtract(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out);
+        static void batch_multiply(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out);
+        static void batch_multiply(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out);
+        static void batch_divide(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out);
+        static void batch_divide(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out);
+
+        // out[i] = -1, 0 or 1 as lhs[i] is less than, equal to or greater than rhs[i] (or rhs)
+        static void batch_compare(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<int> out);
+        static void batch_compare(span<const BasicFraction> lhs, const BasicFraction &rhs, span<int> out);
 
         // Getter and setter functions
-        int getNumerator() const;
-        int getDenominator() const;
+        constexpr IntT getNumerator() const;
+        constexpr IntT getDenominator() const;
     };
 
+    /**
+    Constructor for initializing a Fraction object with default values.
+    Sets the numerator to 0 and denominator to 1.
+    */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction() : numerator(0), denominator(1) {}
+
+    /**
+    Constructs a Fraction object with the given numerator and denominator.
+    @param numerator The numerator of the fraction
+    @param denominator The denominator of the fraction
+    @throws std::invalid_argument If the denominator is 0
+    @post The created Fraction object will be in reduced form (i.e., with the greatest common divisor of the numerator and denominator factored out).
+    If the fraction is negative, then it will be represented with a negative numerator and positive denominator.
+    */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction(IntT numerator, IntT denominator) : numerator(numerator), denominator(denominator)
+    {
+        throw_if_error(try_normalize(this->numerator, this->denominator));
+    }
+
+    /**
+     * Non-throwing counterpart of the (numerator, denominator) constructor.
+     * @return The reduced fraction, or FractionError::zero_denominator / FractionError::overflow
+     * (a negative denominator whose negation does not fit)
+     */
+    template <typename IntT>
+    constexpr Checked<BasicFraction<IntT>> BasicFraction<IntT>::checked_create(IntT numerator, IntT denominator)
+    {
+        Checked<BasicFraction> result;
+        result.error = try_normalize(numerator, denominator);
+        if (result.ok())
+        {
+                result.value.numerator = numerator;
+                result.value.denominator = denominator;
+        }
+        return result;
+    }
+
+    /**
+     * Constructs a Fraction object from a numerator and denominator that are already normalized.
+     * @pre gcd(numerator, denominator) == 1 and denominator > 0
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction(IntT numerator, IntT denominator, normalized) : numerator(move(numerator)), denominator(move(denominator)) {}
+
+    /**
+     * Constructs a Fraction object from a floating-point number.
+     * @param num the floating-point number to convert to a fraction
+     * The numerator is set to num multiplied by 1000 and cast to an integer, while the denominator is set to 1000.
+     * The resulting fraction is then reduced to its simplest form.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction(float num) : numerator(static_cast<IntT>(num * 1000)), denominator(1000)
+    {
+        reduce();
+    }
+
+    /**
+     * Converts a double to the fraction it represents exactly.
+     * A finite double is mantissa * 2^exponent with an integer mantissa; shifting out the mantissa's trailing
+     * zero bits leaves it odd, so mantissa / 2^-exponent is in lowest terms without a gcd.
+     * @throws invalid_argument for infinities and NaN
+     * @throws overflow_error if the numerator or the denominator does not fit IntT
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::from_double_exact(double num)
+    {
+        const uint64_t bits = bit_cast<uint64_t>(num);
+        const bool negative = (bits >> 63) != 0;
+        const int biased_exponent = static_cast<int>((bits >> 52) & 0x7ff);
+        uint64_t mantissa = bits & ((uint64_t{1} << 52) - 1);
+        if (biased_exponent == 0x7ff)
+                throw invalid_argument("Cannot convert infinity or NaN to a fraction.");
+        if (biased_exponent == 0 && mantissa == 0)
+                return BasicFraction();
+
+        // Subnormals have no implicit leading bit and the exponent of the smallest normal
+        int exponent = biased_exponent == 0 ? -1074 : biased_exponent - 1075;
+        if (biased_exponent != 0)
+                mantissa |= uint64_t{1} << 52;
+        const int zeros = count_trailing_zeros(mantissa);
+        mantissa >>= zeros;
+        exponent += zeros;
+
+        const IntT odd = static_cast<IntT>(static_cast<int64_t>(mantissa));
+        if (odd != static_cast<int64_t>(mantissa))
+                throw overflow_error("Overflow");
+        IntT numerator = odd;
+        IntT denominator = 1;
+        if (exponent >= 0 ? shift_left_overflow(odd, exponent, numerator) : shift_left_overflow(IntT(1), -exponent, denominator))
+                throw overflow_error("Overflow");
+        return BasicFraction(negative ? IntT(0) - numerator : numerator, denominator, normalized());
+    }
+
+    /**
+     * Returns the best rational approximation of num with a denominator of at most max_denominator:
+     * no other fraction with such a denominator is closer to num. Ties go to the smaller denominator, and
+     * between two integers to the one closer to zero.
+     * Types up to 64 bits search over the exact value in __int128, which holds every double in [2^-64, 2^63);
+     * smaller magnitudes round to 0 and larger ones do not fit. Wider types search in BigInt.
+     * @throws invalid_argument for infinities, NaN or max_denominator < 1
+     * @throws overflow_error if the numerator does not fit IntT
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::from_double(double num, IntT max_denominator)
+    {
+        if (max_denominator < 1)
+                throw invalid_argument("The maximum denominator must be positive.");
+        if (num != num || num == numeric_limits<double>::infinity() || num == -numeric_limits<double>::infinity())
+                throw invalid_argument("Cannot convert infinity or NaN to a fraction.");
+        if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int64_t))
+        {
+            const double magnitude = num < 0 ? -num : num;
+            if (magnitude >= 0x1p63)
+                throw overflow_error("Overflow");
+            if (magnitude < 0x1p-64)
+                return BasicFraction();
+            return best_approximation(BasicFraction<__int128>::from_double_exact(num), max_denominator);
+        }
+        else
+        {
+            return best_approximation(BasicFraction<BigInt>::from_double_exact(num), max_denominator);
+        }
+    }
+
+    /**
+     * Walks the continued fraction [a0; a1, a2, ...] of |exact| while the convergents' denominators stay within
+     * max_denominator. The answer is the last such convergent p1/q1 or the semiconvergent (p0 + k*p1)/(q0 + k*q1)
+     * with the largest admissible k, which lies on the other side of the value.
+     * With y the complete quotient where the walk stopped (a = floor(y) > k), the convergent is at least as close
+     * exactly when y >= 2k + q0/q1, which only needs a comparison of the remainder when a == 2k.
+     * No intermediate exceeds |exact| * max_denominator + 1 or the terms of exact itself.
+     */
+    template <typename IntT>
+    template <typename WideT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::best_approximation(const BasicFraction<WideT> &exact, IntT max_denominator)
+    {
+        const bool negative = exact.getNumerator() < 0;
+        const WideT limit = WideT(max_denominator);
+        WideT num = negative ? WideT(0) - exact.getNumerator() : exact.getNumerator();
+        WideT den = exact.getDenominator();
+
+        WideT num_0 = 0;
+        WideT den_0 = 1;
+        WideT num_1 = 1;
+        WideT den_1 = 0;
+        bool exhausted = false;
+        WideT term = 0;
+        while (true)
+        {
+                term = num / den;
+                if (den_1 != 0 && term > (limit - den_0) / den_1)
+                    break;
+                const WideT next_num = num_0 + term * num_1;
+                const WideT next_den = den_0 + term * den_1;
+                num_0 = num_1;
+                den_0 = den_1;
+                num_1 = next_num;
+                den_1 = next_den;
+                const WideT rest = num - term * den;
+                num = den;
+                den = rest;
+                if (den == 0)
+                {
+                    exhausted = true;
+                    break;
+                }
+        }
+
+        if (!exhausted)
+        {
+                const WideT steps = (limit - den_0) / den_1;
+                const WideT twice = steps + steps;
+                bool semiconvergent = term < twice;
+                if (term == twice)
+                    semiconvergent = BasicFraction<WideT>(num - term * den, den) < BasicFraction<WideT>(den_0, den_1);
+                if (semiconvergent)
+                {
+                    num_1 = num_0 + steps * num_1;
+                    den_1 = den_0 + steps * den_1;
+                }
+        }
+
+        if constexpr (numeric_limits<IntT>::is_bounded)
+        {
+            if (num_1 > WideT(numeric_limits<IntT>::max()))
+                throw overflow_error("Overflow");
+        }
+        const IntT result_num = static_cast<IntT>(num_1);
+        return BasicFraction(negative ? IntT(0) - result_num : result_num, static_cast<IntT>(den_1), normalized());
+    }
+
+    /**
+     * Copy constructor for the Fraction class.
+     * @param other The Fraction object to copy.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction(const BasicFraction &other) : numerator(other.numerator), denominator(other.denominator) {}
+
+    /**
+     * Move constructor for the Fraction class.
+     * @param other The Fraction object to move.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT>::BasicFraction(BasicFraction &&other) noexcept : numerator(move(other.numerator)), denominator(move(other.denominator)) {}
+
+    /**
+     * This is the assignment operator, which assigns the values of the given Fraction object to the current object.
+     * It returns a reference to the current object after assignment.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator=(const BasicFraction &other)
+    {
+        if (this == &other)
+                return *this;
+
+        this->numerator = other.numerator;
+        this->denominator = other.denominator;
+        return *this;
+    }
+
+    /**
+     * This is the move assignment operator, which moves the values of the given Fraction object to the current object.
+     * It returns a reference to the current object after move.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator=(BasicFraction &&other) noexcept
+    {
+        if (this == &other)
+                return *this;
+
+        this->numerator = move(other.numerator);
+        this->denominator = move(other.denominator);
+        return *this;
+    }
+
+    /**
+     * This is a helper function that reduces the current fraction to its simplest form by dividing both numerator
+     * and denominator by their greatest common divisor (see Gcd.hpp for the gcd engine).
+     */
+    template <typename IntT>
+    constexpr void BasicFraction<IntT>::reduce()
+    {
+        if (denominator < 0)
+        {
+                numerator = -numerator;
+                denominator = -denominator;
+        }
+        IntT my_gcd = fraction_gcd(numerator, denominator);
+        numerator /= my_gcd;
+        denominator /= my_gcd;
+    }
+
+    /**
+     * Brings a numerator/denominator pair to lowest terms with a positive denominator.
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_normalize(IntT &numerator, IntT &denominator)
+    {
+        if (denominator == 0)
+                return FractionError::zero_denominator;
+        if (numerator == 0)
+        {
+                denominator = 1;
+                return FractionError::none;
+        }
+
+        IntT my_gcd = fraction_gcd(numerator, denominator);
+        numerator /= my_gcd;
+        denominator /= my_gcd;
+        if (denominator < 0 &&
+            (subtract_overflow(IntT(0), numerator, numerator) || subtract_overflow(IntT(0), denominator, denominator)))
+                return FractionError::overflow;
+        return FractionError::none;
+    }
+
+    /**
+     * Maps a FractionError to the exception the throwing API has always used for it.
+     */
+    template <typename IntT>
+    constexpr void BasicFraction<IntT>::throw_if_error(FractionError error)
+    {
+        switch (error)
+        {
+        case FractionError::none:
+                return;
+        case FractionError::overflow:
+                throw overflow_error("Overflow");
+        case FractionError::zero_denominator:
+                throw invalid_argument("Denominator cannot be zero.");
+        case FractionError::division_by_zero:
+                throw runtime_error("Cannot divide by zero.");
+        }
+    }
+
+    /**
+     * This is the implementation of the + and - operators for Fraction objects (op is '+' or '-').
+     * It follows Knuth (TAOCP vol. 2, 4.5.1): with g = gcd(d1, d2) the result is t / ((d1 / g) * (d2 / g2)),
+     * where t = n1 * (d2 / g) op n2 * (d1 / g) and g2 = gcd(t, g). That result is already in lowest terms
+     * (0 comes out as 0/1), so it is built without another reduce().
+     * t can overflow IntT even when the result fits (e.g. 2/3 + INT_MAX/3); try_add_or_subtract_wide then
+     * recomputes it, so only sums whose reduced form does not fit report FractionError::overflow
+     * (overflow_error when thrown).
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_add_or_subtract(const BasicFraction &num1, const BasicFraction &num2, char op, BasicFraction &result)
+    {
+        IntT my_gcd = fraction_gcd(num1.denominator, num2.denominator);
+        IntT den_1 = num1.denominator / my_gcd;
+        IntT den_2 = num2.denominator / my_gcd;
+        IntT scaled_1{};
+        IntT scaled_2{};
+        IntT num{};
+        if (multiply_overflow(num1.numerator, den_2, scaled_1) || multiply_overflow(num2.numerator, den_1, scaled_2) ||
+            (op == '-' ? subtract_overflow(scaled_1, scaled_2, num) : add_overflow(scaled_1, scaled_2, num)))
+        {
+                return try_add_or_subtract_wide(num1, num2, op, my_gcd, result);
+        }
+
+        // With coprime denominators the result is already in lowest terms
+        IntT den{};
+        if (my_gcd == 1)
+        {
+                if (multiply_overflow(den_1, num2.denominator, den))
+                    return FractionError::overflow;
+                result.numerator = move(num);
+                result.denominator = move(den);
+                return FractionError::none;
+        }
+
+        IntT second_gcd = fraction_gcd(num, my_gcd);
+        if (multiply_overflow(den_1, IntT(num2.denominator / second_gcd), den))
+                return FractionError::overflow;
+        num /= second_gcd;
+        result.numerator = move(num);
+        result.denominator = move(den);
+        return FractionError::none;
+    }
+
+    /**
+     * Knuth's sum for the case where t overflows IntT, with every step in a type where it cannot overflow
+     * (int64_t for int, __int128 for int64_t, BigInt for __int128) and the reduced result narrowed at the end,
+     * like the int batch kernel. g2 divides g, so it is taken from t % g in IntT.
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_add_or_subtract_wide(const BasicFraction &num1, const BasicFraction &num2, char op, IntT my_gcd, BasicFraction &result)
+    {
+        if constexpr (!numeric_limits<IntT>::is_bounded)
+        {
+            // BigInt never overflows, so it never gets here
+            return FractionError::overflow;
+        }
+        else
+        {
+            auto knuth = [&]<typename WideT>(type_identity<WideT>)
+            {
+                const WideT den_1 = WideT(num1.denominator / my_gcd);
+                const WideT scaled_1 = WideT(num1.numerator) * WideT(num2.denominator / my_gcd);
+                const WideT scaled_2 = WideT(num2.numerator) * den_1;
+                WideT num = op == '-' ? scaled_1 - scaled_2 : scaled_1 + scaled_2;
+                const IntT second_gcd = fraction_gcd(static_cast<IntT>(num % WideT(my_gcd)), my_gcd);
+                num /= WideT(second_gcd);
+                const WideT den = den_1 * WideT(num2.denominator / second_gcd);
+                if (num > WideT(numeric_limits<IntT>::max()) || num < WideT(numeric_limits<IntT>::min()) || den > WideT(numeric_limits<IntT>::max()))
+                    return FractionError::overflow;
+                result.numerator = static_cast<IntT>(num);
+                result.denominator = static_cast<IntT>(den);
+                return FractionError::none;
+            };
+
+            if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int32_t))
+                return knuth(type_identity<int64_t>());
+            else if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int64_t))
+                return knuth(type_identity<__int128>());
+            else
+                return knuth(type_identity<BigInt>());
+        }
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::add_or_subtract(const BasicFraction &num1, const BasicFraction &num2, char op)
+    {
+        BasicFraction result;
+        throw_if_error(try_add_or_subtract(num1, num2, op, result));
+        return result;
+    }
+
+    /**
+     * This is the implementation of the * operator for Fraction objects.
+     * It multiplies two fractions and returns the result as a new Fraction object.
+     * Both operands are in lowest terms, so cancelling gcd(n1, d2) and gcd(n2, d1) before multiplying
+     * leaves a product that is in lowest terms as well and needs no further reduction.
+     * A gcd of 1 (always the case when one of its terms is 1) cancels nothing, and its two divisions are skipped.
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_multiply(const BasicFraction &num1, const BasicFraction &num2, BasicFraction &result)
+    {
+        const IntT gcd_1 = fraction_gcd(num1.numerator, num2.denominator);
+        const IntT gcd_2 = fraction_gcd(num2.numerator, num1.denominator);
+        IntT num_1 = num1.numerator;
+        IntT den_2 = num2.denominator;
+        IntT num_2 = num2.numerator;
+        IntT den_1 = num1.denominator;
+        if (gcd_1 != IntT(1))
+        {
+                num_1 /= gcd_1;
+                den_2 /= gcd_1;
+        }
+        if (gcd_2 != IntT(1))
+        {
+                num_2 /= gcd_2;
+                den_1 /= gcd_2;
+        }
+        IntT numerator{};
+        IntT denominator{};
+        if (multiply_overflow(num_1, num_2, numerator) || multiply_overflow(den_1, den_2, denominator))
+        {
+                return FractionError::overflow;
+        }
+        result.numerator = move(numerator);
+        result.denominator = move(denominator);
+        return FractionError::none;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::multiply(const BasicFraction &num1, const BasicFraction &num2)
+    {
+        BasicFraction result;
+        throw_if_error(try_multiply(num1, num2, result));
+        return result;
+    }
+
+    /**
+     * This is the implementation of the / operator for Fraction objects.
+     * It divides one fraction by another and returns the result as a new Fraction object.
+     * Fails with FractionError::division_by_zero (runtime_error when thrown) if the divisor is zero.
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_divide(const BasicFraction &num1, const BasicFraction &num2, BasicFraction &result)
+    {
+        if (num2.numerator == 0)
+        {
+                return FractionError::division_by_zero;
+        }
+
+        // Multiplication by the reciprocal, cross-cancelling gcd(n1, n2) and gcd(d1, d2).
+        // The divisor's sign moves to the numerator factor before multiplying, so a numerator of
+        // numeric_limits<IntT>::min() is reached directly instead of by negating a product that overflowed.
+        IntT gcd_1 = fraction_gcd(num1.numerator, num2.numerator);
+        IntT gcd_2 = fraction_gcd(num1.denominator, num2.denominator);
+        IntT num_factor = num1.numerator / gcd_1;
+        IntT den_factor = num2.numerator / gcd_1;
+        if (den_factor < 0 &&
+            (subtract_overflow(IntT(0), num_factor, num_factor) || subtract_overflow(IntT(0), den_factor, den_factor)))
+        {
+                return FractionError::overflow;
+        }
+        IntT numerator{};
+        IntT denominator{};
+        if (multiply_overflow(num_factor, IntT(num2.denominator / gcd_2), numerator) ||
+            multiply_overflow(IntT(num1.denominator / gcd_2), den_factor, denominator))
+        {
+                return FractionError::overflow;
+        }
+        result.numerator = move(numerator);
+        result.denominator = move(denominator);
+        return FractionError::none;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::divide(const BasicFraction &num1, const BasicFraction &num2)
+    {
+        BasicFraction result;
+        throw_if_error(try_divide(num1, num2, result));
+        return result;
+    }
+
+    /**
+     * This is the implementation of fma: num1 * num2 + num3 = (n1 * n2 * d3 + n3 * d1 * d2) / (d1 * d2 * d3),
+     * reduced once, instead of the product's two cross-cancelling gcds and the sum's two.
+     * For int the terms are computed in int64_t, or in __int128 (where they cannot overflow) if they do not fit;
+     * other bounded types check every step and, if one overflows, fall back to the two operators, which only
+     * fail when a reduced result does not fit.
+     */
+    template <typename IntT>
+    constexpr FractionError BasicFraction<IntT>::try_multiply_add(const BasicFraction &num1, const BasicFraction &num2, const BasicFraction &num3, BasicFraction &result)
+    {
+        // Unreduced terms of the result in WideT; false if a step overflows
+        auto unreduced = [&]<typename WideT>(WideT &num, WideT &den)
+        {
+            WideT num_12{};
+            WideT den_12{};
+            WideT scaled_12{};
+            WideT scaled_3{};
+            return !(multiply_overflow(WideT(num1.numerator), WideT(num2.numerator), num_12) ||
+                     multiply_overflow(WideT(num1.denominator), WideT(num2.denominator), den_12) ||
+                     multiply_overflow(num_12, WideT(num3.denominator), scaled_12) || multiply_overflow(WideT(num3.numerator), den_12, scaled_3) ||
+                     add_overflow(scaled_12, scaled_3, num) || multiply_overflow(den_12, WideT(num3.denominator), den));
+        };
+        auto store = [&]<typename WideT>(WideT num, WideT den)
+        {
+            const WideT my_gcd = fraction_gcd(num, den);
+            num /= my_gcd;
+            den /= my_gcd;
+            if constexpr (!is_same_v<WideT, IntT>)
+            {
+                if (num > WideT(numeric_limits<IntT>::max()) || num < WideT(numeric_limits<IntT>::min()) || den > WideT(numeric_limits<IntT>::max()))
+                    return FractionError::overflow;
+            }
+            result.numerator = static_cast<IntT>(num);
+            result.denominator = static_cast<IntT>(den);
+            return FractionError::none;
+        };
+
+        if constexpr (is_same_v<IntT, int>)
+        {
+            int64_t num = 0;
+            int64_t den = 0;
+            if (unreduced(num, den))
+                return store(num, den);
+            __int128 wide_num = 0;
+            __int128 wide_den = 0;
+            unreduced(wide_num, wide_den);
+            return store(wide_num, wide_den);
+        }
+        else
+        {
+            IntT num{};
+            IntT den{};
+            if (unreduced(num, den))
+                return store(num, den);
+            BasicFraction product;
+            const FractionError error = try_multiply(num1, num2, product);
+            return error != FractionError::none ? error : try_add_or_subtract(product, num3, '+', result);
+        }
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::multiply_add(const BasicFraction &num1, const BasicFraction &num2, const BasicFraction &num3)
+    {
+        BasicFraction result;
+        throw_if_error(try_multiply_add(num1, num2, num3, result));
+        return result;
+    }
+
+    /**
+     * Knuth's sum as in try_add_or_subtract, updating the terms in place: n1 becomes t = n1 * (d2 / g) +- n2 * (d1 / g)
+     * and d1 becomes d1 / g, then both are divided by g2 = gcd(t, g) and d1 is scaled by d2 / g2.
+     * Everything read from other is taken before the terms change, so other may be this object.
+     */
+    template <typename IntT>
+    constexpr void BasicFraction<IntT>::add_or_subtract_in_place(const BasicFraction &other, char op)
+    {
+        const IntT my_gcd = fraction_gcd(denominator, other.denominator);
+        const IntT den_2 = other.denominator / my_gcd;
+        denominator /= my_gcd;
+        const IntT scaled_2 = other.numerator * denominator;
+        numerator *= den_2;
+        if (op == '-')
+                numerator -= scaled_2;
+        else
+                numerator += scaled_2;
+
+        // With coprime denominators the result is already in lowest terms
+        if (my_gcd == IntT(1))
+        {
+                denominator *= den_2;
+                return;
+        }
+        const IntT second_gcd = fraction_gcd(numerator, my_gcd);
+        numerator /= second_gcd;
+        denominator *= den_2 * (my_gcd / second_gcd);
+    }
+
+    // try_multiply's cross-cancelled product, with other's factors taken before the terms change
+    template <typename IntT>
+    constexpr void BasicFraction<IntT>::multiply_in_place(const BasicFraction &other)
+    {
+        const IntT gcd_1 = fraction_gcd(numerator, other.denominator);
+        const IntT gcd_2 = fraction_gcd(other.numerator, denominator);
+        const IntT num_factor = other.numerator / gcd_2;
+        const IntT den_factor = other.denominator / gcd_1;
+        numerator /= gcd_1;
+        numerator *= num_factor;
+        denominator /= gcd_2;
+        denominator *= den_factor;
+    }
+
+    // try_divide's product with the reciprocal, with the divisor's sign moved to the numerator factor
+    template <typename IntT>
+    constexpr void BasicFraction<IntT>::divide_in_place(const BasicFraction &other)
+    {
+        if (other.numerator == IntT(0))
+                throw_if_error(FractionError::division_by_zero);
+        const IntT gcd_1 = fraction_gcd(numerator, other.numerator);
+        const IntT gcd_2 = fraction_gcd(denominator, other.denominator);
+        const bool negative = other.numerator < IntT(0);
+        IntT num_factor = other.denominator / gcd_2;
+        IntT den_factor = other.numerator / gcd_1;
+        if (negative)
+        {
+                num_factor = IntT(0) - num_factor;
+                den_factor = IntT(0) - den_factor;
+        }
+        numerator /= gcd_1;
+        numerator *= num_factor;
+        denominator /= gcd_2;
+        denominator *= den_factor;
+    }
+
+    /**
+     * In-place counterparts of the arithmetic operators. For fixed-width types the try_ functions read both
+     * operands before storing the result terms into this object, so it can be both an operand and the result;
+     * a failed operation leaves it unchanged. Unbounded types cannot overflow and update their terms in place.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator+=(const BasicFraction &other)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+                throw_if_error(try_add_or_subtract(*this, other, '+', *this));
+        else
+                add_or_subtract_in_place(other, '+');
+        return *this;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator-=(const BasicFraction &other)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+                throw_if_error(try_add_or_subtract(*this, other, '-', *this));
+        else
+                add_or_subtract_in_place(other, '-');
+        return *this;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator*=(const BasicFraction &other)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+                throw_if_error(try_multiply(*this, other, *this));
+        else
+                multiply_in_place(other);
+        return *this;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator/=(const BasicFraction &other)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+                throw_if_error(try_divide(*this, other, *this));
+        else
+                divide_in_place(other);
+        return *this;
+    }
+
+    /**
+     * This is the implementation of the == operator for Fraction objects.
+     * It checks if two fractions are equal and returns true if they are, otherwise false.
+     */
+    template <typename IntT>
+    constexpr bool BasicFraction<IntT>::equal(const BasicFraction &num1, const BasicFraction &num2)
+    {
+        return (num1.numerator == num2.numerator && num1.denominator == num2.denominator);
+    }
+
+    /**
+     * Three-way comparison behind operator<=>: returns a negative value, zero or a positive value
+     * as num1 is less than, equal to or greater than num2.
+     * Denominators are positive, so num1 < num2 exactly when n1 * d2 < n2 * d1. The cross products are
+     * computed in a type twice as wide as IntT, where they cannot overflow; __int128 has no wider type and
+     * falls back to comparing continued fractions only when a product overflows. BigInt never overflows.
+     */
+    template <typename IntT>
+    constexpr int BasicFraction<IntT>::compare(const BasicFraction &num1, const BasicFraction &num2)
+    {
+        if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int32_t))
+        {
+            const int64_t left = int64_t{num1.numerator} * num2.denominator;
+            const int64_t right = int64_t{num2.numerator} * num1.denominator;
+            return (left > right) - (left < right);
+        }
+        else if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int64_t))
+        {
+            const __int128 left = static_cast<__int128>(num1.numerator) * num2.denominator;
+            const __int128 right = static_cast<__int128>(num2.numerator) * num1.denominator;
+            return (left > right) - (left < right);
+        }
+        else
+        {
+            IntT left{};
+            IntT right{};
+            if (multiply_overflow(num1.numerator, num2.denominator, left) || multiply_overflow(num2.numerator, num1.denominator, right))
+                return compare_continued_fraction(num1.numerator, num1.denominator, num2.numerator, num2.denominator);
+            return (left > right) - (left < right);
+        }
+    }
+
+    /**
+     * Compares num_1/den_1 with num_2/den_2 (positive denominators) without forming any product,
+     * by walking both continued fractions until their terms differ.
+     * Each step compares the integer parts (floor division) and, when they agree, the reciprocals
+     * of the remainders in swapped order: r1/d1 < r2/d2 exactly when d2/r2 < d1/r1.
+     */
+    template <typename IntT>
+    constexpr int BasicFraction<IntT>::compare_continued_fraction(IntT num_1, IntT den_1, IntT num_2, IntT den_2)
+    {
+        while (true)
+        {
+                IntT whole_1 = num_1 / den_1;
+                IntT rest_1 = num_1 % den_1;
+                if (rest_1 < 0)
+                {
+                    whole_1 -= 1;
+                    rest_1 += den_1;
+                }
+                IntT whole_2 = num_2 / den_2;
+                IntT rest_2 = num_2 % den_2;
+                if (rest_2 < 0)
+                {
+                    whole_2 -= 1;
+                    rest_2 += den_2;
+                }
+
+                if (whole_1 != whole_2)
+                    return whole_1 < whole_2 ? -1 : 1;
+                if (rest_1 == 0 || rest_2 == 0)
+                    return (rest_1 != 0) - (rest_2 != 0);
+
+                IntT next_num_1 = den_2;
+                IntT next_den_1 = rest_2;
+                num_2 = den_1;
+                den_2 = rest_1;
+                num_1 = next_num_1;
+                den_1 = next_den_1;
+        }
+    }
+
+    // The numerator of the float constructor's n/1000: like an implicit conversion, num is first narrowed to float
+    template <typename IntT>
+    constexpr IntT BasicFraction<IntT>::scale(double num)
+    {
+        return static_cast<IntT>(static_cast<float>(num) * 1000);
+    }
+
+    /**
+     * Returns scaled/1000 in lowest terms. 1000 = 2^3 * 5^3, so the common factors can only be
+     * 2s and 5s; removing them takes at most six divisions by constants instead of a gcd.
+     */
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::from_scaled(IntT scaled)
+    {
+        if (scaled == 0)
+                return BasicFraction();
+        IntT den = 1000;
+        for (int i = 0; i < 3 && scaled % 2 == 0; ++i)
+        {
+                scaled /= 2;
+                den /= 2;
+        }
+        for (int i = 0; i < 3 && scaled % 5 == 0; ++i)
+        {
+                scaled /= 5;
+                den /= 5;
+        }
+        return BasicFraction(scaled, den, normalized());
+    }
+
+    // Compares num1 with scaled/1000 like compare(), widening the cross products instead of reducing scaled/1000
+    template <typename IntT>
+    constexpr int BasicFraction<IntT>::compare_scaled(const BasicFraction &num1, IntT scaled)
+    {
+        if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int32_t))
+        {
+            const int64_t left = int64_t{num1.numerator} * 1000;
+            const int64_t right = int64_t{scaled} * num1.denominator;
+            return (left > right) - (left < right);
+        }
+        else if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int64_t))
+        {
+            const __int128 left = static_cast<__int128>(num1.numerator) * 1000;
+            const __int128 right = static_cast<__int128>(scaled) * num1.denominator;
+            return (left > right) - (left < right);
+        }
+        else
+        {
+            return compare(num1, from_scaled(scaled));
+        }
+    }
+
+    // Overloaded increment operator ++
+    // gcd(n + d, d) == gcd(n, d) == 1, so the result needs no reduction
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator++()
+    {
+        numerator = overflow_check_add(numerator, denominator);
+        return *this;
+    }
+
+    // Overloaded increment operator ++ (postfix)
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::operator++(int)
+    {
+        BasicFraction temp = *this;
+        ++(*this);
+        return temp;
+    }
+
+    // Overloaded decrement operator --
+    // gcd(n - d, d) == gcd(n, d) == 1, so the result needs no reduction
+    template <typename IntT>
+    constexpr BasicFraction<IntT> &BasicFraction<IntT>::operator--()
+    {
+        numerator = overflow_check_subtract(numerator, denominator);
+        return *this;
+    }
+
+    // Overloaded decrement operator -- (postfix)
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicFraction<IntT>::operator--(int)
+    {
+        BasicFraction temp = *this;
+        --(*this);
+        return temp;
+    }
+
+    /**
+     * Rounds numerator / denominator to FloatT.
+     * When both terms are exactly representable in FloatT one hardware division already rounds correctly.
+     * Otherwise the quotient is computed in integers, scaled by 2^shift so that it has two or three bits
+     * more than FloatT's mantissa; those bits and the remainder decide the rounding.
+     * The scaled terms need at most 118 bits for 64-bit IntT, so they are computed in __int128 (BigInt for wider types).
+     */
+    template <typename IntT>
+    template <typename FloatT>
+    FloatT BasicFraction<IntT>::to_floating() const
+    {
+        constexpr int digits = numeric_limits<FloatT>::digits;
+        constexpr auto exact_limit = int64_t{1} << digits;
+        if constexpr (is_integral_v<IntT> && sizeof(IntT) <= sizeof(int32_t) && digits >= 32)
+        {
+            return static_cast<FloatT>(numerator) / static_cast<FloatT>(denominator);
+        }
+        else
+        {
+            if (numerator >= -exact_limit && numerator <= exact_limit && denominator <= exact_limit)
+            {
+                const auto num = static_cast<int64_t>(static_cast<__int128>(numerator));
+                const auto den = static_cast<int64_t>(static_cast<__int128>(denominator));
+                return static_cast<FloatT>(num) / static_cast<FloatT>(den);
+            }
+            if (numerator == 0)
+                return 0;
+
+            using WideT = conditional_t<is_integral_v<IntT> && sizeof(IntT) <= sizeof(int64_t), __int128, BigInt>;
+            const bool negative = numerator < 0;
+            const WideT magnitude = negative ? WideT(0) - WideT(numerator) : WideT(numerator);
+            const WideT divisor = WideT(denominator);
+            const int shift = digits + 2 + bit_length(divisor) - bit_length(magnitude);
+
+            WideT scaled_num = magnitude;
+            WideT scaled_den = divisor;
+            if (shift > 0)
+                shift_left_overflow(magnitude, shift, scaled_num);
+            else
+                shift_left_overflow(divisor, -shift, scaled_den);
+            const WideT quotient = scaled_num / scaled_den;
+            const bool sticky = quotient * scaled_den != scaled_num;
+
+            // quotient has digits + 2 or digits + 3 bits: keep digits of them and round on the rest
+            const auto bits = static_cast<uint64_t>(static_cast<__int128>(quotient));
+            const int extra = bit_length(static_cast<unsigned __int128>(bits)) - digits;
+            uint64_t mantissa = bits >> extra;
+            const uint64_t rest = bits & ((uint64_t{1} << extra) - 1);
+            const uint64_t half = uint64_t{1} << (extra - 1);
+            if (rest > half || (rest == half && (sticky || (mantissa & 1) != 0)))
+                ++mantissa;
+            const FloatT result = ldexp(static_cast<FloatT>(mantissa), extra - shift);
+            return negative ? -result : result;
+        }
+    }
+
+    template <typename IntT>
+    double BasicFraction<IntT>::to_double() const
+    {
+        return to_floating<double>();
+    }
+
+    template <typename IntT>
+    float BasicFraction<IntT>::to_float() const
+    {
+        return to_floating<float>();
+    }
+
+    // The int loop is a plain int-to-double conversion and division per element, which compilers vectorize
+    template <typename IntT>
+    void BasicFraction<IntT>::to_double(span<const BasicFraction> fractions, span<double> out)
+    {
+        if (out.size() < fractions.size())
+                throw invalid_argument("Output array is shorter than the input.");
+        for (size_t i = 0; i < fractions.size(); ++i)
+                out[i] = fractions[i].to_double();
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::to_float(span<const BasicFraction> fractions, span<float> out)
+    {
+        if (out.size() < fractions.size())
+                throw invalid_argument("Output array is shorter than the input.");
+        for (size_t i = 0; i < fractions.size(); ++i)
+                out[i] = fractions[i].to_float();
+    }
+
+    /**
+     * Applies Op ('+', '-', '*' or '/') to every element.
+     * For int every intermediate of each element fits in 64 bits, so the kernels skip the per-step overflow
+     * checks: products are computed unreduced in 64 bits and reduced with a single gcd (the scalar operator
+     * cross-cancels instead, since its products must fit IntT), and sums use Knuth's two small gcds. The reduced result is range-checked once per element before it is stored,
+     * so like the scalar path the loop stops at the first failing element and never stores truncated terms.
+     * Other backing types run the scalar kernels element by element.
+     */
+    template <typename IntT>
+    template <char Op, typename LhsAt, typename RhsAt, typename Store>
+    void BasicFraction<IntT>::batch_apply(size_t count, LhsAt lhs, RhsAt rhs, Store store)
+    {
+        if constexpr (is_same_v<IntT, int>)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const BasicFraction &left = lhs(i);
+                const BasicFraction &right = rhs(i);
+                const int64_t num_1 = left.numerator;
+                const int64_t den_1 = left.denominator;
+                int64_t num_2 = right.numerator;
+                int64_t den_2 = right.denominator;
+                if constexpr (Op == '/')
+                {
+                    if (num_2 == 0)
+                        throw runtime_error("Cannot divide by zero.");
+                    // Multiply by the reciprocal, keeping its denominator positive
+                    const int64_t reciprocal_num = num_2 < 0 ? -den_2 : den_2;
+                    den_2 = num_2 < 0 ? -num_2 : num_2;
+                    num_2 = reciprocal_num;
+                }
+
+                int64_t num = 0;
+                int64_t den = 0;
+                if constexpr (Op == '+' || Op == '-')
+                {
+                    // Knuth's addition as in try_add_or_subtract, with every intermediate exact in 64 bits
+                    // (the divisions stay in 32 bits, which is markedly cheaper than 64-bit division)
+                    const int common = fraction_gcd(static_cast<int>(den_1), static_cast<int>(den_2));
+                    const int reduced_1 = static_cast<int>(den_1) / common;
+                    const int reduced_2 = static_cast<int>(den_2) / common;
+                    const int64_t sum = Op == '+' ? num_1 * reduced_2 + num_2 * reduced_1 : num_1 * reduced_2 - num_2 * reduced_1;
+                    const int second_common = common == 1 ? 1 : fraction_gcd(static_cast<int>(sum % common), common);
+                    num = sum / second_common;
+                    den = int64_t{reduced_1} * (static_cast<int>(den_2) / second_common);
+                }
+                else
+                {
+                    num = num_1 * num_2;
+                    den = den_1 * den_2;
+                    const int64_t common = fraction_gcd(num, den);
+                    num /= common;
+                    den /= common;
+                }
+
+                if (num != static_cast<int>(num) || den != static_cast<int>(den))
+                    throw overflow_error("Overflow");
+                store(i, static_cast<int>(num), static_cast<int>(den));
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                BasicFraction result;
+                if constexpr (Op == '+' || Op == '-')
+                    throw_if_error(try_add_or_subtract(lhs(i), rhs(i), Op, result));
+                else if constexpr (Op == '*')
+                    throw_if_error(try_multiply(lhs(i), rhs(i), result));
+                else
+                    throw_if_error(try_divide(lhs(i), rhs(i), result));
+                store(i, move(result.numerator), move(result.denominator));
+            }
+        }
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::check_batch_sizes(size_t lhs_size, size_t rhs_size, size_t out_size)
+    {
+        if (rhs_size != lhs_size)
+                throw invalid_argument("Operand arrays have different lengths.");
+        if (out_size < lhs_size)
+                throw invalid_argument("Output array is shorter than the input.");
+    }
+
+    template <typename IntT>
+    template <char Op>
+    void BasicFraction<IntT>::batch_apply(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out)
+    {
+        check_batch_sizes(lhs.size(), rhs.size(), out.size());
+        batch_apply<Op>(
+            lhs.size(), [&](size_t i) -> const BasicFraction & { return lhs[i]; }, [&](size_t i) -> const BasicFraction & { return rhs[i]; },
+            [&](size_t i, IntT numerator, IntT denominator) { out[i] = BasicFraction(move(numerator), move(denominator), normalized()); });
+    }
+
+    // rhs is copied first, since it may be an element of out
+    template <typename IntT>
+    template <char Op>
+    void BasicFraction<IntT>::batch_apply(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out)
+    {
+        check_batch_sizes(lhs.size(), lhs.size(), out.size());
+        const BasicFraction scalar = rhs;
+        batch_apply<Op>(
+            lhs.size(), [&](size_t i) -> const BasicFraction & { return lhs[i]; }, [&](size_t) -> const BasicFraction & { return scalar; },
+            [&](size_t i, IntT numerator, IntT denominator) { out[i] = BasicFraction(move(numerator), move(denominator), normalized()); });
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_add(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out)
+    {
+        batch_apply<'+'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_add(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out)
+    {
+        batch_apply<'+'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_subtract(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out)
+    {
+        batch_apply<'-'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_subtract(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out)
+    {
+        batch_apply<'-'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_multiply(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out)
+    {
+        batch_apply<'*'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_multiply(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out)
+    {
+        batch_apply<'*'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_divide(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<BasicFraction> out)
+    {
+        batch_apply<'/'>(lhs, rhs, out);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_divide(span<const BasicFraction> lhs, const BasicFraction &rhs, span<BasicFraction> out)
+    {
+        batch_apply<'/'>(lhs, rhs, out);
+    }
+
+    // For int every comparison is one pair of 64-bit products, a loop compilers vectorize
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_compare(span<const BasicFraction> lhs, span<const BasicFraction> rhs, span<int> out)
+    {
+        check_batch_sizes(lhs.size(), rhs.size(), out.size());
+        for (size_t i = 0; i < lhs.size(); ++i)
+                out[i] = compare(lhs[i], rhs[i]);
+    }
+
+    template <typename IntT>
+    void BasicFraction<IntT>::batch_compare(span<const BasicFraction> lhs, const BasicFraction &rhs, span<int> out)
+    {
+        check_batch_sizes(lhs.size(), lhs.size(), out.size());
+        for (size_t i = 0; i < lhs.size(); ++i)
+                out[i] = compare(lhs[i], rhs);
+    }
+
+    // Getter for numerator
+    template <typename IntT>
+    constexpr IntT BasicFraction<IntT>::getNumerator() const
+    {
+        return numerator;
+    }
+
+    // Getter for denominator
+    template <typename IntT>
+    constexpr IntT BasicFraction<IntT>::getDenominator() const
+    {
+        return denominator;
+    }
+
+    // Writes an integer of any backing type; __int128 has no stream operator.
+    template <typename IntT>
+    void write_integer(ostream &output, const IntT &value)
+    {
+        if constexpr (!is_same_v<IntT, __int128>)
+        {
+            output << value;
+        }
+        else
+        {
+            using UIntT = typename unsigned_of<IntT>::type;
+            UIntT magnitude = value < 0 ? UIntT(0) - static_cast<UIntT>(value) : static_cast<UIntT>(value);
+            string digits;
+            do
+            {
+                digits.insert(digits.begin(), static_cast<char>('0' + static_cast<int>(magnitude % 10)));
+                magnitude /= 10;
+            } while (magnitude != 0);
+            if (value < 0)
+                digits.insert(digits.begin(), '-');
+            output << digits;
+        }
+    }
+
+    // Reads an integer of any backing width, setting failbit like the built-in extractors do.
+    template <typename IntT>
+    void read_integer(istream &input, IntT &value)
+    {
+        if constexpr (!is_same_v<IntT, __int128>)
+        {
+            input >> value;
+        }
+        else
+        {
+            input >> ws;
+            const bool negative = input.peek() == '-';
+            if (negative || input.peek() == '+')
+                input.get();
+
+            IntT result = 0;
+            bool any_digit = false;
+            while (isdigit(input.peek()) != 0)
+            {
+                const IntT digit = input.get() - '0';
+                if (result > (numeric_limits<IntT>::max() - digit) / 10)
+                {
+                    input.setstate(ios::failbit);
+                    return;
+                }
+                result = result * 10 + digit;
+                any_digit = true;
+            }
+
+            if (!any_digit)
+            {
+                input.setstate(ios::failbit);
+                return;
+            }
+            value = negative ? -result : result;
+        }
+    }
+
+    // Implementation of the output operator <<
+    template <typename IntT>
+    ostream &BasicFraction<IntT>::write(ostream &output, const BasicFraction &fraction)
+    {
+        write_integer(output, fraction.numerator);
+        output << "/";
+        write_integer(output, fraction.denominator);
+        return output;
+    }
+
+    // Implementation of the input operator >>
+    template <typename IntT>
+    istream &BasicFraction<IntT>::read(istream &input, BasicFraction &fraction)
+    {
+        read_integer(input, fraction.numerator);
+        read_integer(input, fraction.denominator);
+
+        if (input.fail())
+        {
+                throw runtime_error("Input error");
+        }
+
+        if (fraction.denominator == 0)
+        {
+                throw runtime_error("Denominator cannot be zero");
+        }
+        fraction.reduce();
+        return input;
+    }
+
+    // The original 32-bit fraction
+    using Fraction = BasicFraction<int>;
+    // Wider backing storage for values that overflow int
+    using Fraction64 = BasicFraction<int64_t>;
+    using Fraction128 = BasicFraction<__int128>;
+    // Arbitrary precision; never throws overflow_error
+    using BigFraction = BasicFraction<BigInt>;
+
+    // By default the non-inline members (stream I/O) are compiled once, in Fraction.cpp and BigFraction.cpp.
+    // Defining FRACTION_HEADER_ONLY instantiates everything in the including translation unit instead,
+    // so no Fraction object file has to be linked and the optimizer sees every definition.
+#ifndef FRACTION_HEADER_ONLY
+    extern template class BasicFraction<int>;
+    extern template class BasicFraction<int64_t>;
+    extern template class BasicFraction<__int128>;
+    extern template class BasicFraction<BigInt>;
+#endif
+
 };
 
 #endif // FRACTION_HPP
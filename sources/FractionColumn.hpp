@@ -0,0 +1,377 @@
+#ifndef FRACTION_COLUMN_HPP
+#define FRACTION_COLUMN_HPP
+#include "Fraction.hpp"
+#include "FractionSimd.hpp"
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <span>
+#include <vector>
+
+using namespace std;
+
+namespace ariel
+{
+    // Allocator that aligns every array to a cache line, so vector loads never straddle two lines
+    template <typename T>
+    struct CacheAlignedAllocator
+    {
+        using value_type = T;
+        static constexpr align_val_t alignment{64};
+
+        CacheAlignedAllocator() = default;
+        template <typename OtherT>
+        CacheAlignedAllocator(const CacheAlignedAllocator<OtherT> &) {}
+
+        T *allocate(size_t count) { return static_cast<T *>(::operator new(count * sizeof(T), alignment)); }
+        void deallocate(T *pointer, size_t) { ::operator delete(pointer, alignment); }
+
+        template <typename OtherT>
+        bool operator==(const CacheAlignedAllocator<OtherT> &) const { return true; }
+    };
+
+    /**
+     * A column of fractions stored as a structure of arrays: all numerators in one aligned array and all
+     * denominators in another, so column-wide passes (comparisons, conversions, "do all rows share a
+     * denominator?") read contiguous integers instead of interleaved pairs.
+     * Elements are kept normalized like BasicFraction; indexing and iteration yield BasicFraction values.
+     */
+    template <typename IntT>
+    class BasicFractionColumn
+    {
+    private:
+        using Array = vector<IntT, CacheAlignedAllocator<IntT>>;
+        using FractionT = BasicFraction<IntT>;
+
+        Array numerator_array;
+        Array denominator_array;
+
+        // Batch kernel shared by the arithmetic below
+        template <char Op, typename RhsAt>
+        static void apply(const BasicFractionColumn &lhs, size_t rhs_size, RhsAt rhs, BasicFractionColumn &out);
+
+    public:
+        using value_type = FractionT;
+
+        // Random-access iterator yielding the elements by value
+        class const_iterator
+        {
+        private:
+            const BasicFractionColumn *column = nullptr;
+            ptrdiff_t index = 0;
+
+        public:
+            using iterator_concept = random_access_iterator_tag;
+            using iterator_category = input_iterator_tag;
+            using value_type = FractionT;
+            using difference_type = ptrdiff_t;
+            using reference = FractionT;
+            using pointer = void;
+
+            const_iterator() = default;
+            const_iterator(const BasicFractionColumn *column, ptrdiff_t index) : column(column), index(index) {}
+
+            FractionT operator*() const { return (*column)[static_cast<size_t>(index)]; }
+            FractionT operator[](ptrdiff_t offset) const { return (*column)[static_cast<size_t>(index + offset)]; }
+
+            const_iterator &operator++()
+            {
+                ++index;
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator previous = *this;
+                ++index;
+                return previous;
+            }
+            const_iterator &operator--()
+            {
+                --index;
+                return *this;
+            }
+            const_iterator operator--(int)
+            {
+                const_iterator previous = *this;
+                --index;
+                return previous;
+            }
+            const_iterator &operator+=(ptrdiff_t offset)
+            {
+                index += offset;
+                return *this;
+            }
+            const_iterator &operator-=(ptrdiff_t offset)
+            {
+                index -= offset;
+                return *this;
+            }
+
+            friend const_iterator operator+(const_iterator iterator, ptrdiff_t offset) { return iterator += offset; }
+            friend const_iterator operator+(ptrdiff_t offset, const_iterator iterator) { return iterator += offset; }
+            friend const_iterator operator-(const_iterator iterator, ptrdiff_t offset) { return iterator -= offset; }
+            friend ptrdiff_t operator-(const const_iterator &first, const const_iterator &second) { return first.index - second.index; }
+            friend bool operator==(const const_iterator &first, const const_iterator &second) { return first.index == second.index; }
+            friend auto operator<=>(const const_iterator &first, const const_iterator &second) { return first.index <=> second.index; }
+        };
+
+        // constructor
+        BasicFractionColumn() = default;
+        explicit BasicFractionColumn(size_t count) : numerator_array(count, IntT(0)), denominator_array(count, IntT(1)) {}
+        BasicFractionColumn(span<const FractionT> fractions)
+        {
+            reserve(fractions.size());
+            for (const FractionT &fraction : fractions)
+                push_back(fraction);
+        }
+
+        size_t size() const { return numerator_array.size(); }
+        bool empty() const { return numerator_array.empty(); }
+        void reserve(size_t count)
+        {
+            numerator_array.reserve(count);
+            denominator_array.reserve(count);
+        }
+        // New elements are 0/1
+        void resize(size_t count)
+        {
+            numerator_array.resize(count, IntT(0));
+            denominator_array.resize(count, IntT(1));
+        }
+        void clear()
+        {
+            numerator_array.clear();
+            denominator_array.clear();
+        }
+
+        void push_back(const FractionT &fraction)
+        {
+            numerator_array.push_back(fraction.numerator);
+            denominator_array.push_back(fraction.denominator);
+        }
+
+        FractionT operator[](size_t index) const { return FractionT(numerator_array[index], denominator_array[index], typename FractionT::normalized()); }
+        void set(size_t index, const FractionT &fraction)
+        {
+            numerator_array[index] = fraction.numerator;
+            denominator_array[index] = fraction.denominator;
+        }
+
+        // Replaces the contents with numerators[i] / denominators[i], e.g. terms accumulated without reducing,
+        // and normalizes the whole column in one batch pass. The spans are reduced in place.
+        // Throws invalid_argument for a zero denominator and overflow_error if a reduced term does not fit IntT.
+        void assign_unreduced(span<int64_t> numerators, span<int64_t> denominators);
+
+        // The raw arrays, aligned to 64 bytes
+        span<const IntT> numerators() const { return numerator_array; }
+        span<const IntT> denominators() const { return denominator_array; }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, static_cast<ptrdiff_t>(size())); }
+
+        // True when every element has the same denominator (vacuously true when empty)
+        bool has_common_denominator() const;
+
+        // out[i] = the i-th element rounded like BasicFraction::to_double; out must be at least size() long
+        void to_double(span<double> out) const;
+
+        // Column arithmetic: out = lhs op rhs element-wise, or lhs op rhs for a single fraction.
+        // out is resized to lhs.size() and may be lhs or rhs itself. Throws like BasicFraction's operators.
+        static void batch_add(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out);
+        static void batch_add(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out);
+        static void batch_subtract(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out);
+        static void batch_subtract(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out);
+        static void batch_multiply(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out);
+        static void batch_multiply(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out);
+        static void batch_divide(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out);
+        static void batch_divide(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out);
+
+        // out[i] = -1, 0 or 1 as lhs[i] is less than, equal to or greater than rhs[i] (or rhs)
+        static void batch_compare(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, span<int> out);
+        static void batch_compare(const BasicFractionColumn &lhs, const FractionT &rhs, span<int> out);
+    };
+
+    using FractionColumn = BasicFractionColumn<int>;
+    using FractionColumn64 = BasicFractionColumn<int64_t>;
+
+    // Compares every denominator with the first one; the loop has no early exit, so it vectorizes
+    template <typename IntT>
+    bool BasicFractionColumn<IntT>::has_common_denominator() const
+    {
+        if (empty())
+                return true;
+        const IntT first = denominator_array[0];
+        bool common = true;
+        for (const IntT &denominator : denominator_array)
+                common &= denominator == first;
+        return common;
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::to_double(span<double> out) const
+    {
+        if (out.size() < size())
+                throw invalid_argument("Output array is shorter than the input.");
+        if constexpr (is_same_v<IntT, int>)
+        {
+            // int terms are exact in double, so one division per element is correctly rounded
+            const int *numerators = numerator_array.data();
+            const int *denominators = denominator_array.data();
+            double *result = out.data();
+            for (size_t i = 0; i < size(); ++i)
+                result[i] = static_cast<double>(numerators[i]) / static_cast<double>(denominators[i]);
+        }
+        else
+        {
+            for (size_t i = 0; i < size(); ++i)
+                out[i] = (*this)[i].to_double();
+        }
+    }
+
+    /**
+     * For int the terms are validated first, then reduce_terms finds all the gcds in lockstep and the
+     * reduced terms are narrowed; other backing types reduce each element through the constructor.
+     */
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::assign_unreduced(span<int64_t> numerators, span<int64_t> denominators)
+    {
+        FractionT::check_batch_sizes(numerators.size(), denominators.size(), numerators.size());
+        if constexpr (is_same_v<IntT, int>)
+        {
+            bool zero_denominator = false;
+            bool out_of_range = false;
+            for (size_t i = 0; i < numerators.size(); ++i)
+            {
+                zero_denominator |= denominators[i] == 0;
+                out_of_range |= numerators[i] == numeric_limits<int64_t>::min() || denominators[i] == numeric_limits<int64_t>::min();
+            }
+            if (zero_denominator)
+                throw invalid_argument("Denominator cannot be zero.");
+            if (out_of_range)
+                throw overflow_error("Overflow");
+
+            reduce_terms(numerators.data(), denominators.data(), numerators.size());
+            for (size_t i = 0; i < numerators.size(); ++i)
+                out_of_range |= numerators[i] != static_cast<int>(numerators[i]) || denominators[i] != static_cast<int>(denominators[i]);
+            if (out_of_range)
+                throw overflow_error("Overflow");
+            resize(numerators.size());
+            for (size_t i = 0; i < numerators.size(); ++i)
+            {
+                numerator_array[i] = static_cast<int>(numerators[i]);
+                denominator_array[i] = static_cast<int>(denominators[i]);
+            }
+        }
+        else
+        {
+            BasicFractionColumn result;
+            result.reserve(numerators.size());
+            for (size_t i = 0; i < numerators.size(); ++i)
+                result.push_back(FractionT(IntT(numerators[i]), IntT(denominators[i])));
+            *this = move(result);
+        }
+    }
+
+    /**
+     * Runs BasicFraction's batch kernel on the two arrays. The results are written through separate
+     * numerator and denominator stores, which is safe when out is lhs or rhs because each element is
+     * read before it is written.
+     */
+    template <typename IntT>
+    template <char Op, typename RhsAt>
+    void BasicFractionColumn<IntT>::apply(const BasicFractionColumn &lhs, size_t rhs_size, RhsAt rhs, BasicFractionColumn &out)
+    {
+        FractionT::check_batch_sizes(lhs.size(), rhs_size, lhs.size());
+        out.resize(lhs.size());
+        IntT *numerators = out.numerator_array.data();
+        IntT *denominators = out.denominator_array.data();
+        FractionT::template batch_apply<Op>(
+            lhs.size(), [&](size_t i) { return lhs[i]; }, rhs,
+            [&](size_t i, IntT numerator, IntT denominator)
+            {
+                numerators[i] = move(numerator);
+                denominators[i] = move(denominator);
+            });
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_add(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out)
+    {
+        apply<'+'>(lhs, rhs.size(), [&](size_t i) { return rhs[i]; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_add(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out)
+    {
+        const FractionT scalar = rhs;
+        apply<'+'>(lhs, lhs.size(), [&](size_t) -> const FractionT & { return scalar; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_subtract(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out)
+    {
+        apply<'-'>(lhs, rhs.size(), [&](size_t i) { return rhs[i]; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_subtract(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out)
+    {
+        const FractionT scalar = rhs;
+        apply<'-'>(lhs, lhs.size(), [&](size_t) -> const FractionT & { return scalar; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_multiply(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out)
+    {
+        apply<'*'>(lhs, rhs.size(), [&](size_t i) { return rhs[i]; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_multiply(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out)
+    {
+        const FractionT scalar = rhs;
+        apply<'*'>(lhs, lhs.size(), [&](size_t) -> const FractionT & { return scalar; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_divide(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, BasicFractionColumn &out)
+    {
+        apply<'/'>(lhs, rhs.size(), [&](size_t i) { return rhs[i]; }, out);
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_divide(const BasicFractionColumn &lhs, const FractionT &rhs, BasicFractionColumn &out)
+    {
+        const FractionT scalar = rhs;
+        apply<'/'>(lhs, lhs.size(), [&](size_t) -> const FractionT & { return scalar; }, out);
+    }
+
+    // For int the loop reads the four arrays front to back and each element is one pair of 64-bit products
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_compare(const BasicFractionColumn &lhs, const BasicFractionColumn &rhs, span<int> out)
+    {
+        FractionT::check_batch_sizes(lhs.size(), rhs.size(), out.size());
+        if constexpr (is_same_v<IntT, int>)
+        {
+            // Cross-multiplies four (AVX2) or two (SSE4.1) pairs per instruction
+            compare_terms(lhs.numerator_array.data(), lhs.denominator_array.data(),
+                          rhs.numerator_array.data(), rhs.denominator_array.data(), out.data(), lhs.size());
+        }
+        else
+        {
+            for (size_t i = 0; i < lhs.size(); ++i)
+                out[i] = FractionT::compare(lhs[i], rhs[i]);
+        }
+    }
+
+    template <typename IntT>
+    void BasicFractionColumn<IntT>::batch_compare(const BasicFractionColumn &lhs, const FractionT &rhs, span<int> out)
+    {
+        FractionT::check_batch_sizes(lhs.size(), lhs.size(), out.size());
+        for (size_t i = 0; i < lhs.size(); ++i)
+                out[i] = FractionT::compare(lhs[i], rhs);
+    }
+
+};
+
+#endif // FRACTION_COLUMN_HPP
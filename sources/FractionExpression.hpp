@@ -0,0 +1,239 @@
+#ifndef FRACTION_EXPRESSION_HPP
+#define FRACTION_EXPRESSION_HPP
+#include "Fraction.hpp"
+#include <concepts>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+using namespace std;
+
+namespace ariel
+{
+    // Expression templates that fuse several fraction operators into one pass.
+    // fuse(a) starts an expression; +, -, * and / with fractions, doubles or other expressions then build
+    // a tree of nodes instead of computing, e.g.
+    //     Fraction c = fuse(a) + b - 1;
+    // Converting the tree to BasicFraction (or calling evaluate()) computes it bottom-up on unreduced
+    // terms of a wider accumulator type: no per-operator gcd, lcm or narrowing, and one reduce at the end.
+    // Plain BasicFraction operators are unchanged.
+
+    // Accumulator type of the fused evaluation: int -> int64_t, int64_t -> __int128, wider types keep their own
+    template <typename IntT>
+    struct fused_accumulator
+    {
+        using type = IntT;
+    };
+
+    template <>
+    struct fused_accumulator<int>
+    {
+        using type = int64_t;
+    };
+
+    template <>
+    struct fused_accumulator<int64_t>
+    {
+        using type = __int128;
+    };
+
+    // Numerator and denominator of a subexpression, not necessarily in lowest terms (denominator > 0)
+    template <typename WideT>
+    struct UnreducedTerms
+    {
+        WideT numerator;
+        WideT denominator;
+    };
+
+    // Node types declare is_fraction_expression and int_type, and evaluate to UnreducedTerms of the accumulator
+    template <typename T>
+    concept FractionExpression = T::is_fraction_expression && requires { typename T::int_type; };
+
+    template <typename IntT>
+    class FractionLeaf;
+
+    template <char Op, typename Lhs, typename Rhs>
+    class FractionBinary;
+
+    // Shared by every node: the conversion that evaluates the tree and reduces its result once
+    template <typename Derived, typename IntT>
+    class FractionExpressionBase
+    {
+    public:
+        static constexpr bool is_fraction_expression = true;
+        using int_type = IntT;
+        using wide_type = typename fused_accumulator<IntT>::type;
+
+        /**
+         * Evaluates the whole expression and reduces the result once.
+         * @throws overflow_error if the reduced result does not fit IntT (intermediate results may be wider)
+         * @throws runtime_error if a divisor is zero
+         */
+        constexpr BasicFraction<IntT> evaluate() const
+        {
+            const UnreducedTerms<wide_type> terms = static_cast<const Derived &>(*this).terms();
+            const BasicFraction<wide_type> reduced(terms.numerator, terms.denominator);
+            if constexpr (!is_same_v<wide_type, IntT>)
+            {
+                if (reduced.getNumerator() > wide_type(numeric_limits<IntT>::max()) || reduced.getNumerator() < wide_type(numeric_limits<IntT>::min()) ||
+                    reduced.getDenominator() > wide_type(numeric_limits<IntT>::max()))
+                    throw overflow_error("Overflow");
+            }
+            return BasicFraction<IntT>(reduced);
+        }
+
+        constexpr operator BasicFraction<IntT>() const { return evaluate(); }
+    };
+
+    // A fraction operand, copied into the expression so that the tree can outlive temporaries
+    template <typename IntT>
+    class FractionLeaf : public FractionExpressionBase<FractionLeaf<IntT>, IntT>
+    {
+    private:
+        IntT numerator;
+        IntT denominator;
+
+    public:
+        using wide_type = typename fused_accumulator<IntT>::type;
+
+        constexpr FractionLeaf(const BasicFraction<IntT> &fraction) : numerator(fraction.getNumerator()), denominator(fraction.getDenominator()) {}
+        // The value of BasicFraction(float), n / 1000 with n = num * 1000, left unreduced except that whole
+        // numbers (the 1 in a + b - 1) become n / 1, which keeps the products of the evaluation small
+        constexpr explicit FractionLeaf(double num) : numerator(static_cast<IntT>(static_cast<float>(num) * 1000)), denominator(1000)
+        {
+            if (numerator % IntT(1000) == 0)
+            {
+                numerator /= IntT(1000);
+                denominator = 1;
+            }
+        }
+
+        constexpr UnreducedTerms<wide_type> terms() const { return {wide_type(numerator), wide_type(denominator)}; }
+    };
+
+    /**
+     * lhs Op rhs. Sums use n1 * d2 op n2 * d1 over d1 * d2 (or just n1 op n2 over a shared denominator),
+     * products and quotients multiply the terms crosswise. If the accumulator overflows, both sides are
+     * reduced and combined with BasicFraction's operators in the accumulator type instead, which cross-cancel
+     * and only throw when the reduced intermediate itself does not fit.
+     */
+    template <char Op, typename Lhs, typename Rhs>
+    class FractionBinary : public FractionExpressionBase<FractionBinary<Op, Lhs, Rhs>, typename Lhs::int_type>
+    {
+    private:
+        Lhs lhs;
+        Rhs rhs;
+
+    public:
+        using wide_type = typename fused_accumulator<typename Lhs::int_type>::type;
+
+        constexpr FractionBinary(const Lhs &lhs, const Rhs &rhs) : lhs(lhs), rhs(rhs) {}
+
+        constexpr UnreducedTerms<wide_type> terms() const
+        {
+            const UnreducedTerms<wide_type> left = lhs.terms();
+            const UnreducedTerms<wide_type> right = rhs.terms();
+            if constexpr (Op == '/')
+            {
+                if (right.numerator == 0)
+                    throw runtime_error("Cannot divide by zero.");
+            }
+
+            UnreducedTerms<wide_type> result{};
+            bool overflow = false;
+            if constexpr (Op == '+' || Op == '-')
+            {
+                if (left.denominator == right.denominator)
+                {
+                    result.denominator = left.denominator;
+                    overflow = Op == '+' ? add_overflow(left.numerator, right.numerator, result.numerator)
+                                         : subtract_overflow(left.numerator, right.numerator, result.numerator);
+                }
+                else
+                {
+                    wide_type term_1{};
+                    wide_type term_2{};
+                    overflow = multiply_overflow(left.numerator, right.denominator, term_1) ||
+                               multiply_overflow(right.numerator, left.denominator, term_2) ||
+                               multiply_overflow(left.denominator, right.denominator, result.denominator) ||
+                               (Op == '+' ? add_overflow(term_1, term_2, result.numerator) : subtract_overflow(term_1, term_2, result.numerator));
+                }
+            }
+            else if constexpr (Op == '*')
+            {
+                overflow = multiply_overflow(left.numerator, right.numerator, result.numerator) ||
+                           multiply_overflow(left.denominator, right.denominator, result.denominator);
+            }
+            else
+            {
+                overflow = multiply_overflow(left.numerator, right.denominator, result.numerator) ||
+                           multiply_overflow(left.denominator, right.numerator, result.denominator);
+                if (!overflow && result.denominator < 0)
+                    overflow = subtract_overflow(wide_type(0), result.numerator, result.numerator) ||
+                               subtract_overflow(wide_type(0), result.denominator, result.denominator);
+            }
+            if (!overflow)
+                return result;
+
+            const BasicFraction<wide_type> first(left.numerator, left.denominator);
+            const BasicFraction<wide_type> second(right.numerator, right.denominator);
+            BasicFraction<wide_type> exact;
+            if constexpr (Op == '+')
+                exact = first + second;
+            else if constexpr (Op == '-')
+                exact = first - second;
+            else if constexpr (Op == '*')
+                exact = first * second;
+            else
+                exact = first / second;
+            return {exact.getNumerator(), exact.getDenominator()};
+        }
+    };
+
+    // Starts a fused expression with a fraction operand
+    template <typename IntT>
+    constexpr FractionLeaf<IntT> fuse(const BasicFraction<IntT> &fraction)
+    {
+        return FractionLeaf<IntT>(fraction);
+    }
+
+    // Builds the node for lhs Op rhs; fractions and doubles become leaves of the expression's backing type
+    template <char Op, typename Lhs, typename Rhs>
+    constexpr auto make_fraction_binary(const Lhs &lhs, const Rhs &rhs)
+    {
+        if constexpr (FractionExpression<Lhs> && FractionExpression<Rhs>)
+        {
+            static_assert(is_same_v<typename Lhs::int_type, typename Rhs::int_type>, "Fused operands must share a backing type");
+            return FractionBinary<Op, Lhs, Rhs>(lhs, rhs);
+        }
+        else if constexpr (FractionExpression<Lhs>)
+            return make_fraction_binary<Op>(lhs, FractionLeaf<typename Lhs::int_type>(rhs));
+        else
+            return make_fraction_binary<Op>(FractionLeaf<typename Rhs::int_type>(lhs), rhs);
+    }
+
+    // Operators of fused expressions: expression op expression, and either side a fraction or a double
+    template <typename Lhs, typename Rhs>
+    concept FusedOperands = (FractionExpression<Lhs> && FractionExpression<Rhs>) ||
+                            (FractionExpression<Lhs> && (is_same_v<Rhs, BasicFraction<typename Lhs::int_type>> || is_arithmetic_v<Rhs>)) ||
+                            (FractionExpression<Rhs> && (is_same_v<Lhs, BasicFraction<typename Rhs::int_type>> || is_arithmetic_v<Lhs>));
+
+    template <typename Lhs, typename Rhs>
+        requires FusedOperands<Lhs, Rhs>
+    constexpr auto operator+(const Lhs &lhs, const Rhs &rhs) { return make_fraction_binary<'+'>(lhs, rhs); }
+
+    template <typename Lhs, typename Rhs>
+        requires FusedOperands<Lhs, Rhs>
+    constexpr auto operator-(const Lhs &lhs, const Rhs &rhs) { return make_fraction_binary<'-'>(lhs, rhs); }
+
+    template <typename Lhs, typename Rhs>
+        requires FusedOperands<Lhs, Rhs>
+    constexpr auto operator*(const Lhs &lhs, const Rhs &rhs) { return make_fraction_binary<'*'>(lhs, rhs); }
+
+    template <typename Lhs, typename Rhs>
+        requires FusedOperands<Lhs, Rhs>
+    constexpr auto operator/(const Lhs &lhs, const Rhs &rhs) { return make_fraction_binary<'/'>(lhs, rhs); }
+
+};
+
+#endif // FRACTION_EXPRESSION_HPP
@@ -0,0 +1,387 @@
+#include "FractionSimd.hpp"
+#include "Gcd.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FRACTION_SIMD_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace ariel
+{
+    namespace
+    {
+        // Portable versions, also used for the tails the vector loops leave over
+        void multiply_scalar(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                             int64_t *num_out, int64_t *den_out, size_t begin, size_t count)
+        {
+            for (size_t i = begin; i < count; ++i)
+            {
+                num_out[i] = int64_t{num_1[i]} * num_2[i];
+                den_out[i] = int64_t{den_1[i]} * den_2[i];
+            }
+        }
+
+        void scale_scalar(const int *num, const int *den, int num_factor, int den_factor,
+                          int64_t *num_out, int64_t *den_out, size_t begin, size_t count)
+        {
+            for (size_t i = begin; i < count; ++i)
+            {
+                num_out[i] = int64_t{num[i]} * num_factor;
+                den_out[i] = int64_t{den[i]} * den_factor;
+            }
+        }
+
+        void compare_scalar(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                            int *out, size_t begin, size_t count)
+        {
+            for (size_t i = begin; i < count; ++i)
+            {
+                const int64_t left = int64_t{num_1[i]} * den_2[i];
+                const int64_t right = int64_t{num_2[i]} * den_1[i];
+                out[i] = (left > right) - (left < right);
+            }
+        }
+
+        // Divides num / den by their gcd and moves the sign to the numerator
+        void divide_out(int64_t &num, int64_t &den, int64_t gcd)
+        {
+            if (gcd != 1)
+            {
+                num /= gcd;
+                den /= gcd;
+            }
+            if (den < 0)
+            {
+                num = -num;
+                den = -den;
+            }
+        }
+
+        void reduce_scalar(int64_t *num, int64_t *den, size_t begin, size_t count)
+        {
+            for (size_t i = begin; i < count; ++i)
+                divide_out(num[i], den[i], fraction_gcd(num[i], den[i]));
+        }
+
+#ifdef FRACTION_SIMD_X86
+        // _mm*_mul_epi32 multiplies the sign-extended low halves of 64-bit lanes, so four (AVX2) or
+        // two (SSE4.1) ints are widened into 64-bit lanes first and every product is exact.
+
+        __attribute__((target("avx2"))) __m256i load_avx2(const int *source)
+        {
+            return _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(source)));
+        }
+
+        __attribute__((target("avx2"))) void store_avx2(int64_t *target, __m256i value)
+        {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), value);
+        }
+
+        __attribute__((target("avx2"))) void multiply_avx2(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                                                           int64_t *num_out, int64_t *den_out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                store_avx2(num_out + i, _mm256_mul_epi32(load_avx2(num_1 + i), load_avx2(num_2 + i)));
+                store_avx2(den_out + i, _mm256_mul_epi32(load_avx2(den_1 + i), load_avx2(den_2 + i)));
+            }
+            multiply_scalar(num_1, den_1, num_2, den_2, num_out, den_out, i, count);
+        }
+
+        __attribute__((target("avx2"))) void scale_avx2(const int *num, const int *den, int num_factor, int den_factor,
+                                                        int64_t *num_out, int64_t *den_out, size_t count)
+        {
+            const __m256i num_scale = _mm256_set1_epi64x(num_factor);
+            const __m256i den_scale = _mm256_set1_epi64x(den_factor);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                store_avx2(num_out + i, _mm256_mul_epi32(load_avx2(num + i), num_scale));
+                store_avx2(den_out + i, _mm256_mul_epi32(load_avx2(den + i), den_scale));
+            }
+            scale_scalar(num, den, num_factor, den_factor, num_out, den_out, i, count);
+        }
+
+        // The sign of each lane is (right > left) - (left > right) as 0/-1 masks; the low dwords of the
+        // four 64-bit results are then gathered into one 128-bit store.
+        __attribute__((target("avx2"))) void compare_avx2(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                                                          int *out, size_t count)
+        {
+            const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m256i left = _mm256_mul_epi32(load_avx2(num_1 + i), load_avx2(den_2 + i));
+                const __m256i right = _mm256_mul_epi32(load_avx2(num_2 + i), load_avx2(den_1 + i));
+                const __m256i sign = _mm256_sub_epi64(_mm256_cmpgt_epi64(right, left), _mm256_cmpgt_epi64(left, right));
+                const __m256i packed = _mm256_permutevar8x32_epi32(sign, low_dwords);
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm256_castsi256_si128(packed));
+            }
+            compare_scalar(num_1, den_1, num_2, den_2, out, i, count);
+        }
+
+        // Lockstep binary gcd: every iteration replaces (a, b), both odd, by (min(a, b), |a - b| with its
+        // factors of two shifted out); a lane is finished once b reaches 0 and its gcd is then a times the
+        // common power of two. AVX2 has no vector count-trailing-zeros, so the lowest set bit is converted
+        // to float and the shift count read from its exponent. The loop runs until the slowest lane is done,
+        // so blocks whose terms fit in 31 bits use eight 32-bit lanes and only the rest four 64-bit ones.
+
+        // Trailing zero count of every non-zero dword; zero dwords give -127, which srlv treats as >= 32
+        __attribute__((target("avx2"))) __m256i trailing_zeros_32_avx2(__m256i value)
+        {
+            const __m256i lowest = _mm256_and_si256(value, _mm256_sub_epi32(_mm256_setzero_si256(), value));
+            const __m256i exponents = _mm256_and_si256(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(lowest)), 23),
+                                                       _mm256_set1_epi32(0xff));
+            return _mm256_sub_epi32(exponents, _mm256_set1_epi32(127));
+        }
+
+        // The same for 64-bit lanes: the power of two sits in one dword, the other one has exponent field 0
+        __attribute__((target("avx2"))) __m256i trailing_zeros_64_avx2(__m256i value)
+        {
+            const __m256i lowest = _mm256_and_si256(value, _mm256_sub_epi64(_mm256_setzero_si256(), value));
+            const __m256i exponents = _mm256_and_si256(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(lowest)), 23),
+                                                       _mm256_set1_epi32(0xff));
+            const __m256i low = _mm256_and_si256(exponents, _mm256_set1_epi64x(0xffffffff));
+            const __m256i high = _mm256_srli_epi64(exponents, 32);
+            const __m256i in_high = _mm256_and_si256(_mm256_cmpgt_epi64(high, _mm256_setzero_si256()), _mm256_set1_epi64x(32));
+            return _mm256_add_epi64(_mm256_add_epi64(low, high), _mm256_sub_epi64(in_high, _mm256_set1_epi64x(127)));
+        }
+
+        __attribute__((target("avx2"))) __m256i abs_64_avx2(__m256i value)
+        {
+            const __m256i negated = _mm256_sub_epi64(_mm256_setzero_si256(), value);
+            return _mm256_blendv_epi8(value, negated, _mm256_cmpgt_epi64(_mm256_setzero_si256(), value));
+        }
+
+        // gcd of eight (a, b) pairs below 2^31, b non-zero
+        __attribute__((target("avx2"))) __m256i gcd_32_avx2(__m256i first, __m256i second)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            // gcd(0, b) = gcd(b, b)
+            first = _mm256_blendv_epi8(first, second, _mm256_cmpeq_epi32(first, zero));
+            const __m256i shift = trailing_zeros_32_avx2(_mm256_or_si256(first, second));
+            first = _mm256_srlv_epi32(first, trailing_zeros_32_avx2(first));
+            second = _mm256_srlv_epi32(second, trailing_zeros_32_avx2(second));
+            while (!_mm256_testz_si256(second, second))
+            {
+                const __m256i done = _mm256_cmpeq_epi32(second, zero);
+                const __m256i smaller = _mm256_min_epu32(first, second);
+                const __m256i difference = _mm256_sub_epi32(_mm256_max_epu32(first, second), smaller);
+                first = _mm256_blendv_epi8(smaller, first, done);
+                second = _mm256_andnot_si256(done, _mm256_srlv_epi32(difference, trailing_zeros_32_avx2(difference)));
+            }
+            return _mm256_sllv_epi32(first, shift);
+        }
+
+        // gcd of four (a, b) pairs below 2^63, b non-zero
+        __attribute__((target("avx2"))) __m256i gcd_64_avx2(__m256i first, __m256i second)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            first = _mm256_blendv_epi8(first, second, _mm256_cmpeq_epi64(first, zero));
+            const __m256i shift = trailing_zeros_64_avx2(_mm256_or_si256(first, second));
+            first = _mm256_srlv_epi64(first, trailing_zeros_64_avx2(first));
+            second = _mm256_srlv_epi64(second, trailing_zeros_64_avx2(second));
+            while (!_mm256_testz_si256(second, second))
+            {
+                const __m256i done = _mm256_cmpeq_epi64(second, zero);
+                const __m256i greater = _mm256_andnot_si256(done, _mm256_cmpgt_epi64(first, second));
+                const __m256i difference = _mm256_blendv_epi8(_mm256_sub_epi64(second, first), _mm256_sub_epi64(first, second), greater);
+                first = _mm256_blendv_epi8(first, second, greater);
+                second = _mm256_andnot_si256(done, _mm256_srlv_epi64(difference, trailing_zeros_64_avx2(difference)));
+            }
+            return _mm256_sllv_epi64(first, shift);
+        }
+
+        __attribute__((target("avx2"))) void reduce_avx2(int64_t *num, int64_t *den, size_t count)
+        {
+            // Gathers the low dwords of two vectors of four 64-bit lanes into one vector of eight
+            const __m256i low_dwords = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            alignas(32) int64_t gcds[8];
+            alignas(32) int gcds_32[8];
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i num_low = abs_64_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(num + i)));
+                const __m256i num_high = abs_64_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(num + i + 4)));
+                const __m256i den_low = abs_64_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(den + i)));
+                const __m256i den_high = abs_64_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(den + i + 4)));
+                const __m256i all = _mm256_or_si256(_mm256_or_si256(num_low, num_high), _mm256_or_si256(den_low, den_high));
+                if (_mm256_testz_si256(all, _mm256_set1_epi64x(~int64_t{0x7fffffff})))
+                {
+                    const __m256i nums = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(num_low, low_dwords),
+                                                                   _mm256_permutevar8x32_epi32(num_high, low_dwords), 0x20);
+                    const __m256i dens = _mm256_permute2x128_si256(_mm256_permutevar8x32_epi32(den_low, low_dwords),
+                                                                   _mm256_permutevar8x32_epi32(den_high, low_dwords), 0x20);
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(gcds_32), gcd_32_avx2(nums, dens));
+                    for (size_t lane = 0; lane < 8; ++lane)
+                        gcds[lane] = gcds_32[lane];
+                }
+                else
+                {
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(gcds), gcd_64_avx2(num_low, den_low));
+                    _mm256_store_si256(reinterpret_cast<__m256i *>(gcds + 4), gcd_64_avx2(num_high, den_high));
+                }
+                for (size_t lane = 0; lane < 8; ++lane)
+                    divide_out(num[i + lane], den[i + lane], gcds[lane]);
+            }
+            reduce_scalar(num, den, i, count);
+        }
+
+        __attribute__((target("sse4.1"))) __m128i load_sse41(const int *source)
+        {
+            return _mm_cvtepi32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(source)));
+        }
+
+        __attribute__((target("sse4.1"))) void store_sse41(int64_t *target, __m128i value)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(target), value);
+        }
+
+        __attribute__((target("sse4.1"))) void multiply_sse41(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                                                              int64_t *num_out, int64_t *den_out, size_t count)
+        {
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                store_sse41(num_out + i, _mm_mul_epi32(load_sse41(num_1 + i), load_sse41(num_2 + i)));
+                store_sse41(den_out + i, _mm_mul_epi32(load_sse41(den_1 + i), load_sse41(den_2 + i)));
+            }
+            multiply_scalar(num_1, den_1, num_2, den_2, num_out, den_out, i, count);
+        }
+
+        __attribute__((target("sse4.1"))) void scale_sse41(const int *num, const int *den, int num_factor, int den_factor,
+                                                           int64_t *num_out, int64_t *den_out, size_t count)
+        {
+            const __m128i num_scale = _mm_set1_epi64x(num_factor);
+            const __m128i den_scale = _mm_set1_epi64x(den_factor);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                store_sse41(num_out + i, _mm_mul_epi32(load_sse41(num + i), num_scale));
+                store_sse41(den_out + i, _mm_mul_epi32(load_sse41(den + i), den_scale));
+            }
+            scale_scalar(num, den, num_factor, den_factor, num_out, den_out, i, count);
+        }
+
+        // SSE4.1 has no 64-bit signed compare (that is SSE4.2), so the sign of left - right is taken from
+        // its high dword, and an equality test on the whole lane separates 0 from 1.
+        // |left| and |right| are below 2^62, so the difference cannot overflow.
+        __attribute__((target("sse4.1"))) void compare_sse41(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                                                             int *out, size_t count)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i one = _mm_set1_epi32(1);
+            size_t i = 0;
+            for (; i + 2 <= count; i += 2)
+            {
+                const __m128i left = _mm_mul_epi32(load_sse41(num_1 + i), load_sse41(den_2 + i));
+                const __m128i right = _mm_mul_epi32(load_sse41(num_2 + i), load_sse41(den_1 + i));
+                const __m128i difference = _mm_sub_epi64(left, right);
+                const __m128i high = _mm_shuffle_epi32(difference, _MM_SHUFFLE(3, 1, 3, 1));
+                const __m128i equal = _mm_shuffle_epi32(_mm_cmpeq_epi64(difference, zero), _MM_SHUFFLE(2, 0, 2, 0));
+                const __m128i negative = _mm_cmpgt_epi32(zero, high);
+                const __m128i sign = _mm_or_si128(negative, _mm_andnot_si128(equal, one));
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i), sign);
+            }
+            compare_scalar(num_1, den_1, num_2, den_2, out, i, count);
+        }
+
+#endif
+
+        SimdLevel detect_simd_level()
+        {
+#ifdef FRACTION_SIMD_X86
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2"))
+                return SimdLevel::avx2;
+            if (__builtin_cpu_supports("sse4.1"))
+                return SimdLevel::sse41;
+#endif
+            return SimdLevel::scalar;
+        }
+
+        // The requested level, lowered to what the CPU supports
+        SimdLevel usable(SimdLevel level)
+        {
+            return level < simd_level() ? level : simd_level();
+        }
+    }
+
+    SimdLevel simd_level()
+    {
+        static const SimdLevel level = detect_simd_level();
+        return level;
+    }
+
+    void multiply_terms(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                        int64_t *num_out, int64_t *den_out, size_t count, SimdLevel level)
+    {
+        switch (usable(level))
+        {
+#ifdef FRACTION_SIMD_X86
+        case SimdLevel::avx2:
+            multiply_avx2(num_1, den_1, num_2, den_2, num_out, den_out, count);
+            return;
+        case SimdLevel::sse41:
+            multiply_sse41(num_1, den_1, num_2, den_2, num_out, den_out, count);
+            return;
+#endif
+        default:
+            multiply_scalar(num_1, den_1, num_2, den_2, num_out, den_out, 0, count);
+        }
+    }
+
+    void scale_terms(const int *num, const int *den, int num_factor, int den_factor,
+                     int64_t *num_out, int64_t *den_out, size_t count, SimdLevel level)
+    {
+        switch (usable(level))
+        {
+#ifdef FRACTION_SIMD_X86
+        case SimdLevel::avx2:
+            scale_avx2(num, den, num_factor, den_factor, num_out, den_out, count);
+            return;
+        case SimdLevel::sse41:
+            scale_sse41(num, den, num_factor, den_factor, num_out, den_out, count);
+            return;
+#endif
+        default:
+            scale_scalar(num, den, num_factor, den_factor, num_out, den_out, 0, count);
+        }
+    }
+
+    void compare_terms(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                       int *out, size_t count, SimdLevel level)
+    {
+        switch (usable(level))
+        {
+#ifdef FRACTION_SIMD_X86
+        case SimdLevel::avx2:
+            compare_avx2(num_1, den_1, num_2, den_2, out, count);
+            return;
+        case SimdLevel::sse41:
+            compare_sse41(num_1, den_1, num_2, den_2, out, count);
+            return;
+#endif
+        default:
+            compare_scalar(num_1, den_1, num_2, den_2, out, 0, count);
+        }
+    }
+
+    void reduce_terms(int64_t *num, int64_t *den, size_t count, SimdLevel level)
+    {
+        switch (usable(level))
+        {
+#ifdef FRACTION_SIMD_X86
+        case SimdLevel::avx2:
+            reduce_avx2(num, den, count);
+            return;
+#endif
+        default:
+            reduce_scalar(num, den, 0, count);
+        }
+    }
+
+};
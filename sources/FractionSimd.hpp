@@ -0,0 +1,46 @@
+#ifndef FRACTION_SIMD_HPP
+#define FRACTION_SIMD_HPP
+#include <cstddef>
+#include <cstdint>
+
+using namespace std;
+
+namespace ariel
+{
+    // Instruction sets the kernels below are compiled for, in increasing order
+    enum class SimdLevel
+    {
+        scalar,
+        sse41,
+        avx2
+    };
+
+    // The best level the running CPU supports (detected once)
+    SimdLevel simd_level();
+
+    // SIMD kernels over the raw int terms of fraction arrays, e.g. the arrays of a FractionColumn.
+    // Products are exact in 64 bits, so the kernels never overflow and leave reducing to the caller.
+    // Each kernel runs at the requested level, or the best one below it that the CPU supports.
+
+    // num_out[i] / den_out[i] = (num_1[i] * num_2[i]) / (den_1[i] * den_2[i]), not reduced
+    void multiply_terms(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                        int64_t *num_out, int64_t *den_out, size_t count, SimdLevel level = simd_level());
+
+    // num_out[i] / den_out[i] = (num[i] * num_factor) / (den[i] * den_factor), not reduced
+    void scale_terms(const int *num, const int *den, int num_factor, int den_factor,
+                     int64_t *num_out, int64_t *den_out, size_t count, SimdLevel level = simd_level());
+
+    // out[i] = -1, 0 or 1 as num_1[i] / den_1[i] is less than, equal to or greater than num_2[i] / den_2[i]
+    // (positive denominators), by cross-multiplying in 64 bits
+    void compare_terms(const int *num_1, const int *den_1, const int *num_2, const int *den_2,
+                       int *out, size_t count, SimdLevel level = simd_level());
+
+    // Reduces every num[i] / den[i] to lowest terms with a positive denominator, in place, e.g. the output
+    // of multiply_terms. The gcds are computed in lockstep across the lanes with a binary gcd; SSE4.1 lacks
+    // the per-lane shifts this needs, so that level runs the scalar loop.
+    // @pre den[i] != 0 and neither term is INT64_MIN (|term| < 2^63, which holds for products of ints)
+    void reduce_terms(int64_t *num, int64_t *den, size_t count, SimdLevel level = simd_level());
+
+};
+
+#endif // FRACTION_SIMD_HPP
@@ -0,0 +1,126 @@
+#ifndef GCD_HPP
+#define GCD_HPP
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+// The gcd engine used by Fraction::reduce is selected at build time:
+//   (default)           binary (Stein) gcd with count-trailing-zeros
+//   -DFRACTION_STD_GCD  std::gcd from <numeric>
+// e.g. `make FRACTION_FLAGS=-DFRACTION_STD_GCD test1`
+
+namespace ariel
+{
+    // Count the trailing zero bits of a non-zero unsigned value.
+    constexpr int count_trailing_zeros(unsigned int value)
+    {
+        return __builtin_ctz(value);
+    }
+
+    constexpr int count_trailing_zeros(unsigned long value)
+    {
+        return __builtin_ctzl(value);
+    }
+
+    constexpr int count_trailing_zeros(unsigned long long value)
+    {
+        return __builtin_ctzll(value);
+    }
+
+    constexpr int count_trailing_zeros(unsigned __int128 value)
+    {
+        const auto low = static_cast<unsigned long long>(value);
+        if (low != 0)
+            return __builtin_ctzll(low);
+        return 64 + __builtin_ctzll(static_cast<unsigned long long>(value >> 64));
+    }
+
+    // Number of significant bits of an unsigned value (0 for 0).
+    constexpr int bit_length(unsigned __int128 value)
+    {
+        const auto high = static_cast<unsigned long long>(value >> 64);
+        if (high != 0)
+            return 128 - __builtin_clzll(high);
+        const auto low = static_cast<unsigned long long>(value);
+        return low == 0 ? 0 : 64 - __builtin_clzll(low);
+    }
+
+    // Number of significant bits of a non-negative signed value.
+    constexpr int bit_length(__int128 value)
+    {
+        return bit_length(static_cast<unsigned __int128>(value));
+    }
+
+    // std::make_unsigned is not specialized for __int128 in strict -std=c++ modes.
+    template <typename IntT>
+    struct unsigned_of
+    {
+        using type = std::make_unsigned_t<IntT>;
+    };
+
+    template <>
+    struct unsigned_of<__int128>
+    {
+        using type = unsigned __int128;
+    };
+
+    /**
+     * Binary (Stein) gcd of two unsigned integers.
+     * Replaces every division of Euclid's algorithm by shifts and subtractions.
+     * When one of the operands is 1 or a power of two the result is the lowest set bit of (a | b),
+     * so those cases return without entering the loop.
+     */
+    template <typename UIntT>
+    constexpr UIntT binary_gcd(UIntT num1, UIntT num2)
+    {
+        if (num1 == 0)
+            return num2;
+        if (num2 == 0)
+            return num1;
+
+        const UIntT high_bit = UIntT(1) << (sizeof(UIntT) * 8 - 1);
+        const UIntT both = num1 | num2;
+        if ((num1 & (num1 - 1)) == 0 || (num2 & (num2 - 1)) == 0)
+            return both & (~both + 1);
+
+        // The next shift amount is taken from the wrapped difference before the branch-free min/abs step,
+        // which keeps count_trailing_zeros off the critical dependency chain of the loop.
+        const int shift = count_trailing_zeros(both);
+        int zeros = count_trailing_zeros(num1);
+        num2 >>= count_trailing_zeros(num2);
+        while (num1 != 0)
+        {
+            num1 >>= zeros;
+            const UIntT up = num2 - num1;
+            const UIntT down = num1 - num2;
+            zeros = count_trailing_zeros(up | high_bit);
+            const UIntT smaller = num1 < num2 ? num1 : num2;
+            num1 = num1 < num2 ? up : down;
+            num2 = smaller;
+        }
+
+        return num2 << shift;
+    }
+
+    /**
+     * Greatest common divisor of two signed integers, always non-negative.
+     * The result is returned in the signed type, so gcd(min, 0) and gcd(min, min) are not representable;
+     * Fraction only calls it with a positive denominator, which bounds the result.
+     */
+    template <typename IntT>
+    constexpr IntT fraction_gcd(IntT num1, IntT num2)
+    {
+#ifdef FRACTION_STD_GCD
+        // std::gcd rejects __int128, which falls through to the binary engine.
+        if constexpr (std::is_integral_v<IntT>)
+            return std::gcd(num1, num2);
+#endif
+        using UIntT = typename unsigned_of<IntT>::type;
+        const UIntT abs1 = num1 < 0 ? UIntT(0) - static_cast<UIntT>(num1) : static_cast<UIntT>(num1);
+        const UIntT abs2 = num2 < 0 ? UIntT(0) - static_cast<UIntT>(num2) : static_cast<UIntT>(num2);
+        return static_cast<IntT>(binary_gcd(abs1, abs2));
+    }
+
+};
+
+#endif // GCD_HPP
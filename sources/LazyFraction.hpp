@@ -0,0 +1,268 @@
+#ifndef LAZY_FRACTION_HPP
+#define LAZY_FRACTION_HPP
+#include "Fraction.hpp"
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ariel
+{
+    /**
+     * An opt-in fraction that defers reduce() until its value is observed.
+     * Arithmetic keeps the terms unreduced (with a positive denominator) and records that in a flag, so a chain
+     * like a + b - 1 runs no gcd at all; comparing, printing, hashing or reading the terms reduces them once.
+     * When an unreduced term would overflow, the operands are reduced and the operation is redone with
+     * BasicFraction's arithmetic, so results and exceptions are the same as with BasicFraction.
+     * Only bounded backing types are supported: an unbounded BigInt would just keep growing.
+     */
+    template <typename IntT>
+    class BasicLazyFraction
+    {
+        static_assert(numeric_limits<IntT>::is_bounded, "BasicLazyFraction needs a bounded backing type");
+
+    private:
+        using FractionT = BasicFraction<IntT>;
+
+        // Observers reduce the terms in place, so they are mutable
+        mutable IntT numerator;
+        mutable IntT denominator;
+        mutable bool reduced;
+
+        // Trusts denominator > 0
+        constexpr BasicLazyFraction(IntT numerator, IntT denominator, bool reduced) : numerator(numerator), denominator(denominator), reduced(reduced) {}
+
+        // Helper function to reduce the terms if they are not reduced yet
+        constexpr void normalize() const;
+
+        // Implementations of the friend operators below
+        static constexpr BasicLazyFraction add_or_subtract(const BasicLazyFraction &num1, const BasicLazyFraction &num2, char op);
+        static constexpr BasicLazyFraction multiply(const BasicLazyFraction &num1, const BasicLazyFraction &num2);
+        static constexpr BasicLazyFraction divide(const BasicLazyFraction &num1, const BasicLazyFraction &num2);
+
+    public:
+        using value_type = IntT;
+
+        // constructor
+        constexpr BasicLazyFraction() : numerator(0), denominator(1), reduced(true) {}
+        constexpr BasicLazyFraction(IntT numerator, IntT denominator);
+        constexpr BasicLazyFraction(const FractionT &fraction) : numerator(fraction.getNumerator()), denominator(fraction.getDenominator()), reduced(true) {}
+        // The value of BasicFraction(float), num * 1000 / 1000, left unreduced
+        constexpr BasicLazyFraction(float num) : numerator(static_cast<IntT>(num * 1000)), denominator(1000), reduced(false) {}
+
+        // The value as a BasicFraction (reduces)
+        constexpr FractionT value() const;
+        // True when the stored terms are known to be in lowest terms
+        constexpr bool is_reduced() const { return reduced; }
+
+        // Friend operators for arithmetic operations
+        friend constexpr BasicLazyFraction operator+(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return add_or_subtract(num1, num2, '+'); }
+        friend constexpr BasicLazyFraction operator-(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return add_or_subtract(num1, num2, '-'); }
+        friend constexpr BasicLazyFraction operator*(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return multiply(num1, num2); }
+        friend constexpr BasicLazyFraction operator/(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return divide(num1, num2); }
+
+        // Friend operators for comparison operations; both operands are reduced first
+        friend constexpr bool operator==(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return num1.value() == num2.value(); }
+        friend constexpr strong_ordering operator<=>(const BasicLazyFraction &num1, const BasicLazyFraction &num2) { return num1.value() <=> num2.value(); }
+
+        // Overloaded operators for increment and decrement operations
+        constexpr BasicLazyFraction &operator++();   // pre-increment
+        constexpr BasicLazyFraction operator++(int); // post-increment
+        constexpr BasicLazyFraction &operator--();   // pre-decrement
+        constexpr BasicLazyFraction operator--(int); // post-decrement
+
+        // Overloaded operators for input and output operations, in BasicFraction's format
+        friend ostream &operator<<(ostream &output, const BasicLazyFraction &fraction) { return output << fraction.value(); }
+        friend istream &operator>>(istream &input, BasicLazyFraction &fraction)
+        {
+            FractionT value;
+            if (input >> value)
+                fraction = value;
+            return input;
+        }
+
+        double to_double() const { return value().to_double(); }
+        float to_float() const { return value().to_float(); }
+
+        // Getter functions; they return the reduced terms
+        constexpr IntT getNumerator() const;
+        constexpr IntT getDenominator() const;
+    };
+
+    using LazyFraction = BasicLazyFraction<int>;
+    using LazyFraction64 = BasicLazyFraction<int64_t>;
+
+    /**
+     * Constructs a lazy fraction without reducing it; only the sign is moved to the numerator.
+     * When a term's negation does not fit, the fraction is reduced first, as BasicFraction does.
+     * @throws invalid_argument if the denominator is 0
+     * @throws overflow_error if the reduced fraction does not fit either
+     */
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT>::BasicLazyFraction(IntT numerator, IntT denominator) : numerator(numerator), denominator(denominator), reduced(false)
+    {
+        if (denominator == 0)
+                throw invalid_argument("Denominator cannot be zero.");
+        if (denominator < 0)
+        {
+                if (subtract_overflow(IntT(0), numerator, this->numerator) || subtract_overflow(IntT(0), denominator, this->denominator))
+                    *this = FractionT(numerator, denominator);
+        }
+    }
+
+    template <typename IntT>
+    constexpr void BasicLazyFraction<IntT>::normalize() const
+    {
+        if (reduced)
+                return;
+        const IntT common = fraction_gcd(numerator, denominator);
+        if (common != 1)
+        {
+                numerator /= common;
+                denominator /= common;
+        }
+        reduced = true;
+    }
+
+    template <typename IntT>
+    constexpr BasicFraction<IntT> BasicLazyFraction<IntT>::value() const
+    {
+        normalize();
+        return FractionT(numerator, denominator, typename FractionT::normalized());
+    }
+
+    template <typename IntT>
+    constexpr IntT BasicLazyFraction<IntT>::getNumerator() const
+    {
+        normalize();
+        return numerator;
+    }
+
+    template <typename IntT>
+    constexpr IntT BasicLazyFraction<IntT>::getDenominator() const
+    {
+        normalize();
+        return denominator;
+    }
+
+    /**
+     * n1/d - n2/d = (n1 - n2)/d, and otherwise (n1 * d2 op n2 * d1) / (d1 * d2), all without a gcd.
+     * If any step overflows, the eager operator reduces and cross-cancels instead, and only throws
+     * when the reduced result itself does not fit.
+     */
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> BasicLazyFraction<IntT>::add_or_subtract(const BasicLazyFraction &num1, const BasicLazyFraction &num2, char op)
+    {
+        IntT num = 0;
+        IntT den = 0;
+        bool overflow = false;
+        if (num1.denominator == num2.denominator)
+        {
+                den = num1.denominator;
+                overflow = op == '+' ? add_overflow(num1.numerator, num2.numerator, num) : subtract_overflow(num1.numerator, num2.numerator, num);
+        }
+        else
+        {
+                IntT term_1 = 0;
+                IntT term_2 = 0;
+                overflow = multiply_overflow(num1.numerator, num2.denominator, term_1) ||
+                           multiply_overflow(num2.numerator, num1.denominator, term_2) ||
+                           multiply_overflow(num1.denominator, num2.denominator, den) ||
+                           (op == '+' ? add_overflow(term_1, term_2, num) : subtract_overflow(term_1, term_2, num));
+        }
+        if (overflow)
+                return op == '+' ? num1.value() + num2.value() : num1.value() - num2.value();
+        return BasicLazyFraction(num, den, false);
+    }
+
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> BasicLazyFraction<IntT>::multiply(const BasicLazyFraction &num1, const BasicLazyFraction &num2)
+    {
+        IntT num = 0;
+        IntT den = 0;
+        if (multiply_overflow(num1.numerator, num2.numerator, num) || multiply_overflow(num1.denominator, num2.denominator, den))
+                return num1.value() * num2.value();
+        return BasicLazyFraction(num, den, false);
+    }
+
+    /**
+     * (n1 * d2) / (d1 * n2) with the sign moved to the numerator.
+     * @throws runtime_error if num2 is zero
+     */
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> BasicLazyFraction<IntT>::divide(const BasicLazyFraction &num1, const BasicLazyFraction &num2)
+    {
+        if (num2.numerator == 0)
+                throw runtime_error("Cannot divide by zero.");
+        IntT num = 0;
+        IntT den = 0;
+        bool overflow = multiply_overflow(num1.numerator, num2.denominator, num) || multiply_overflow(num1.denominator, num2.numerator, den);
+        if (!overflow && den < 0)
+                overflow = subtract_overflow(IntT(0), num, num) || subtract_overflow(IntT(0), den, den);
+        if (overflow)
+                return num1.value() / num2.value();
+        return BasicLazyFraction(num, den, false);
+    }
+
+    /**
+     * Adds 1 in place: n/d + 1 = (n + d)/d, which keeps a reduced fraction reduced.
+     * @return This fraction
+     */
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> &BasicLazyFraction<IntT>::operator++()
+    {
+        IntT num = 0;
+        if (add_overflow(numerator, denominator, num))
+                *this = ++value();
+        else
+                numerator = num;
+        return *this;
+    }
+
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> BasicLazyFraction<IntT>::operator++(int)
+    {
+        BasicLazyFraction copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> &BasicLazyFraction<IntT>::operator--()
+    {
+        IntT num = 0;
+        if (subtract_overflow(numerator, denominator, num))
+                *this = --value();
+        else
+                numerator = num;
+        return *this;
+    }
+
+    template <typename IntT>
+    constexpr BasicLazyFraction<IntT> BasicLazyFraction<IntT>::operator--(int)
+    {
+        BasicLazyFraction copy = *this;
+        --*this;
+        return copy;
+    }
+
+};
+
+// Equal values hash equally: the reduced terms are hashed
+namespace std
+{
+    template <typename IntT>
+    struct hash<ariel::BasicLazyFraction<IntT>>
+    {
+        size_t operator()(const ariel::BasicLazyFraction<IntT> &fraction) const
+        {
+            const size_t seed = hash<IntT>()(fraction.getNumerator());
+            return seed ^ (hash<IntT>()(fraction.getDenominator()) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2));
+        }
+    };
+};
+
+#endif // LAZY_FRACTION_HPP
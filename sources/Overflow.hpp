@@ -0,0 +1,112 @@
+#ifndef OVERFLOW_HPP
+#define OVERFLOW_HPP
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+namespace ariel
+{
+    // Checked arithmetic primitives, one per operation.
+    // For bounded integer types they compile to the compiler's overflow builtins (a single
+    // add/sub/imul followed by a flag test); unbounded types (BigInt) cannot overflow and
+    // simply compute the result.
+
+    // Stores num1 + num2 in result and returns true if it overflowed
+    template <typename IntT>
+    constexpr bool add_overflow(const IntT &num1, const IntT &num2, IntT &result)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+        {
+            return __builtin_add_overflow(num1, num2, &result);
+        }
+        else
+        {
+            result = num1 + num2;
+            return false;
+        }
+    }
+
+    // Stores num1 - num2 in result and returns true if it overflowed
+    template <typename IntT>
+    constexpr bool subtract_overflow(const IntT &num1, const IntT &num2, IntT &result)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+        {
+            return __builtin_sub_overflow(num1, num2, &result);
+        }
+        else
+        {
+            result = num1 - num2;
+            return false;
+        }
+    }
+
+    // Stores num1 * num2 in result and returns true if it overflowed
+    template <typename IntT>
+    constexpr bool multiply_overflow(const IntT &num1, const IntT &num2, IntT &result)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+        {
+            return __builtin_mul_overflow(num1, num2, &result);
+        }
+        else
+        {
+            result = num1 * num2;
+            return false;
+        }
+    }
+
+    // Stores num * 2^shift in result and returns true if it overflowed (num >= 0, shift >= 0)
+    template <typename IntT>
+    constexpr bool shift_left_overflow(const IntT &num, int shift, IntT &result)
+    {
+        if constexpr (numeric_limits<IntT>::is_bounded)
+        {
+            if (num != 0 && (shift >= numeric_limits<IntT>::digits || (num >> (numeric_limits<IntT>::digits - shift)) != 0))
+                return true;
+            result = num << shift;
+            return false;
+        }
+        else
+        {
+            result = num;
+            for (; shift >= 62; shift -= 62)
+                result *= IntT(int64_t{1} << 62);
+            result *= IntT(int64_t{1} << shift);
+            return false;
+        }
+    }
+
+    // Helper functions that return the result or throw overflow_error
+    template <typename IntT>
+    constexpr IntT overflow_check_add(const IntT &num1, const IntT &num2)
+    {
+        IntT result{};
+        if (add_overflow(num1, num2, result))
+            throw overflow_error("Overflow");
+        return result;
+    }
+
+    template <typename IntT>
+    constexpr IntT overflow_check_subtract(const IntT &num1, const IntT &num2)
+    {
+        IntT result{};
+        if (subtract_overflow(num1, num2, result))
+            throw overflow_error("Overflow");
+        return result;
+    }
+
+    template <typename IntT>
+    constexpr IntT overflow_check_multiply(const IntT &num1, const IntT &num2)
+    {
+        IntT result{};
+        if (multiply_overflow(num1, num2, result))
+            throw overflow_error("Overflow");
+        return result;
+    }
+
+};
+
+#endif // OVERFLOW_HPP
@@ -0,0 +1,166 @@
+#ifndef OVERFLOW_POLICY_HPP
+#define OVERFLOW_POLICY_HPP
+#include "Fraction.hpp"
+#include <type_traits>
+
+using namespace std;
+
+namespace ariel
+{
+    // What the policy-based arithmetic below does when a result does not fit the backing type
+    enum class OverflowPolicy
+    {
+        throw_error, // throw overflow_error, like the operators
+        saturate,    // clamp to [min, max], or round to the nearest fraction whose terms fit
+        promote      // return the result in the next wider backing type
+    };
+
+    // The next wider backing type: int -> int64_t -> __int128 -> BigInt
+    template <typename IntT>
+    struct wider;
+
+    template <>
+    struct wider<int>
+    {
+        using type = int64_t;
+    };
+
+    template <>
+    struct wider<int64_t>
+    {
+        using type = __int128;
+    };
+
+    template <>
+    struct wider<__int128>
+    {
+        using type = BigInt;
+    };
+
+    template <typename IntT>
+    using Wider = typename wider<IntT>::type;
+
+    template <OverflowPolicy Policy, typename IntT>
+    using PolicyResult = conditional_t<Policy == OverflowPolicy::promote, BasicFraction<Wider<IntT>>, BasicFraction<IntT>>;
+
+    /**
+     * Converts an exact fraction of a wider type to IntT, saturating values outside [min, max]
+     * to min/1 or max/1. In-range values whose terms do not fit are rounded to the closest
+     * convergent or semiconvergent of their continued fraction with both terms within IntT's range;
+     * when both are equally close, the convergent (the smaller denominator) is kept.
+     */
+    template <typename IntT, typename WideT>
+    BasicFraction<IntT> saturate(const BasicFraction<WideT> &exact)
+    {
+        const WideT max_int = WideT(numeric_limits<IntT>::max());
+        const WideT min_int = WideT(numeric_limits<IntT>::min());
+        WideT num = exact.getNumerator();
+        WideT den = exact.getDenominator();
+        if (num <= max_int && num >= min_int && den <= max_int)
+                return BasicFraction<IntT>(static_cast<IntT>(num), static_cast<IntT>(den));
+
+        const WideT whole = num / den;
+        if (whole >= max_int)
+                return BasicFraction<IntT>(numeric_limits<IntT>::max(), 1);
+        if (whole <= min_int)
+                return BasicFraction<IntT>(numeric_limits<IntT>::min(), 1);
+
+        // Continued fraction of |num| / den, keeping both terms of every convergent within max_int
+        const bool negative = num < 0;
+        if (negative)
+                num = WideT(0) - num;
+        WideT num_0 = 0;
+        WideT den_0 = 1;
+        WideT num_1 = 1;
+        WideT den_1 = 0;
+        while (den != 0)
+        {
+                const WideT term = num / den;
+                WideT limit = num_1 != 0 ? (max_int - num_0) / num_1 : (max_int - den_0) / den_1;
+                if (num_1 != 0 && den_1 != 0 && (max_int - den_0) / den_1 < limit)
+                    limit = (max_int - den_0) / den_1;
+                if (term > limit)
+                {
+                    // Take the semiconvergent if it is closer than the last convergent: always when
+                    // 2 * limit > term, and for 2 * limit == term when the rest of the expansion is
+                    // smaller than den_0 / den_1, as in best_approximation
+                    bool semiconvergent = limit + limit > term;
+                    if (limit + limit == term)
+                        semiconvergent = BasicFraction<WideT>(num - term * den, den) < BasicFraction<WideT>(den_0, den_1);
+                    if (semiconvergent)
+                    {
+                        num_1 = num_0 + limit * num_1;
+                        den_1 = den_0 + limit * den_1;
+                    }
+                    break;
+                }
+
+                const WideT next_num = num_0 + term * num_1;
+                const WideT next_den = den_0 + term * den_1;
+                num_0 = num_1;
+                den_0 = den_1;
+                num_1 = next_num;
+                den_1 = next_den;
+                const WideT rest = num - term * den;
+                num = den;
+                den = rest;
+        }
+
+        const IntT result_num = static_cast<IntT>(num_1);
+        return BasicFraction<IntT>(negative ? -result_num : result_num, static_cast<IntT>(den_1));
+    }
+
+    // Applies Policy to the outcome of a checked operation; compute_wide redoes it exactly in the wider type
+    template <OverflowPolicy Policy, typename IntT, typename WideOperation>
+    PolicyResult<Policy, IntT> apply_policy(const Checked<BasicFraction<IntT>> &result, WideOperation compute_wide)
+    {
+        if (result.ok())
+                return PolicyResult<Policy, IntT>(result.value);
+        if (result.error == FractionError::division_by_zero)
+                throw runtime_error("Cannot divide by zero.");
+
+        if constexpr (Policy == OverflowPolicy::throw_error)
+                throw overflow_error("Overflow");
+        else if constexpr (Policy == OverflowPolicy::saturate)
+                return saturate<IntT>(compute_wide());
+        else
+                return compute_wide();
+    }
+
+    // Arithmetic with an explicit overflow policy, e.g. multiply<OverflowPolicy::saturate>(a, b).
+    // The narrow type is always tried first, so only overflowing operations pay for the wider type.
+    template <OverflowPolicy Policy, typename IntT>
+    PolicyResult<Policy, IntT> add(const BasicFraction<IntT> &num1, const BasicFraction<IntT> &num2)
+    {
+        using WideFraction = BasicFraction<Wider<IntT>>;
+        return apply_policy<Policy>(checked_add(num1, num2), [&]
+                                    { return WideFraction(num1) + WideFraction(num2); });
+    }
+
+    template <OverflowPolicy Policy, typename IntT>
+    PolicyResult<Policy, IntT> subtract(const BasicFraction<IntT> &num1, const BasicFraction<IntT> &num2)
+    {
+        using WideFraction = BasicFraction<Wider<IntT>>;
+        return apply_policy<Policy>(checked_subtract(num1, num2), [&]
+                                    { return WideFraction(num1) - WideFraction(num2); });
+    }
+
+    template <OverflowPolicy Policy, typename IntT>
+    PolicyResult<Policy, IntT> multiply(const BasicFraction<IntT> &num1, const BasicFraction<IntT> &num2)
+    {
+        using WideFraction = BasicFraction<Wider<IntT>>;
+        return apply_policy<Policy>(checked_multiply(num1, num2), [&]
+                                    { return WideFraction(num1) * WideFraction(num2); });
+    }
+
+    template <OverflowPolicy Policy, typename IntT>
+    PolicyResult<Policy, IntT> divide(const BasicFraction<IntT> &num1, const BasicFraction<IntT> &num2)
+    {
+        using WideFraction = BasicFraction<Wider<IntT>>;
+        return apply_policy<Policy>(checked_divide(num1, num2), [&]
+                                    { return WideFraction(num1) / WideFraction(num2); });
+    }
+
+};
+
+#endif // OVERFLOW_POLICY_HPP